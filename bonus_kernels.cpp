@@ -0,0 +1,190 @@
+#include "bonus_kernels.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(_MSC_VER)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BONUS_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define KERNEL_TARGET(arch)
+#else
+#define KERNEL_TARGET(arch) __attribute__((target(arch)))
+#endif
+#endif
+
+using namespace std;
+
+namespace BonusKernels {
+    namespace {
+        //             FMA,
+        //        .
+        void totalKPIScalar(const double* pc, const double* cq, const double* tw, const double* in,
+            double* total, size_t begin, size_t count) {
+            for (size_t i = begin; i < count; i++) {
+                total[i] = (pc[i] * 0.4 + cq[i] * 0.3 + tw[i] * 0.2 + in[i] * 0.1);
+            }
+        }
+
+        void bonusScalar(const double* salary, const double* kpiScore, const int* experience,
+            double* bonus, size_t begin, size_t count, double kpiCoeff, double expCoeff, double maxExpBonus) {
+            for (size_t i = begin; i < count; i++) {
+                double experienceBonus = min(experience[i] * expCoeff, maxExpBonus);
+                double kpiBonus = kpiScore[i] / 100 * kpiCoeff;
+                bonus[i] = salary[i] * (kpiBonus + experienceBonus);
+            }
+        }
+
+#ifdef BONUS_KERNELS_X86
+        KERNEL_TARGET("sse4.2")
+        void totalKPISSE42(const double* pc, const double* cq, const double* tw, const double* in,
+            double* total, size_t count) {
+            const __m128d w0 = _mm_set1_pd(0.4), w1 = _mm_set1_pd(0.3);
+            const __m128d w2 = _mm_set1_pd(0.2), w3 = _mm_set1_pd(0.1);
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                __m128d sum = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(pc + i), w0), _mm_mul_pd(_mm_loadu_pd(cq + i), w1));
+                sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(tw + i), w2));
+                sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(in + i), w3));
+                _mm_storeu_pd(total + i, sum);
+            }
+            totalKPIScalar(pc, cq, tw, in, total, i, count);
+        }
+
+        KERNEL_TARGET("sse4.2")
+        void bonusSSE42(const double* salary, const double* kpiScore, const int* experience,
+            double* bonus, size_t count, double kpiCoeff, double expCoeff, double maxExpBonus) {
+            const __m128d vExpCoeff = _mm_set1_pd(expCoeff), vMaxExp = _mm_set1_pd(maxExpBonus);
+            const __m128d vKpiCoeff = _mm_set1_pd(kpiCoeff), vHundred = _mm_set1_pd(100);
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                __m128d exp = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(experience + i)));
+                __m128d expBonus = _mm_min_pd(_mm_mul_pd(exp, vExpCoeff), vMaxExp);
+                __m128d kpiBonus = _mm_mul_pd(_mm_div_pd(_mm_loadu_pd(kpiScore + i), vHundred), vKpiCoeff);
+                _mm_storeu_pd(bonus + i, _mm_mul_pd(_mm_loadu_pd(salary + i), _mm_add_pd(kpiBonus, expBonus)));
+            }
+            bonusScalar(salary, kpiScore, experience, bonus, i, count, kpiCoeff, expCoeff, maxExpBonus);
+        }
+
+        KERNEL_TARGET("avx2")
+        void totalKPIAVX2(const double* pc, const double* cq, const double* tw, const double* in,
+            double* total, size_t count) {
+            const __m256d w0 = _mm256_set1_pd(0.4), w1 = _mm256_set1_pd(0.3);
+            const __m256d w2 = _mm256_set1_pd(0.2), w3 = _mm256_set1_pd(0.1);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m256d sum = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(pc + i), w0), _mm256_mul_pd(_mm256_loadu_pd(cq + i), w1));
+                sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(tw + i), w2));
+                sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(in + i), w3));
+                _mm256_storeu_pd(total + i, sum);
+            }
+            totalKPIScalar(pc, cq, tw, in, total, i, count);
+        }
+
+        KERNEL_TARGET("avx2")
+        void bonusAVX2(const double* salary, const double* kpiScore, const int* experience,
+            double* bonus, size_t count, double kpiCoeff, double expCoeff, double maxExpBonus) {
+            const __m256d vExpCoeff = _mm256_set1_pd(expCoeff), vMaxExp = _mm256_set1_pd(maxExpBonus);
+            const __m256d vKpiCoeff = _mm256_set1_pd(kpiCoeff), vHundred = _mm256_set1_pd(100);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m256d exp = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(experience + i)));
+                __m256d expBonus = _mm256_min_pd(_mm256_mul_pd(exp, vExpCoeff), vMaxExp);
+                __m256d kpiBonus = _mm256_mul_pd(_mm256_div_pd(_mm256_loadu_pd(kpiScore + i), vHundred), vKpiCoeff);
+                _mm256_storeu_pd(bonus + i, _mm256_mul_pd(_mm256_loadu_pd(salary + i), _mm256_add_pd(kpiBonus, expBonus)));
+            }
+            bonusScalar(salary, kpiScore, experience, bonus, i, count, kpiCoeff, expCoeff, maxExpBonus);
+        }
+#endif
+
+        atomic<Level>& currentLevel() {
+            static atomic<Level> level(detectLevel());
+            return level;
+        }
+    }
+
+    Level detectLevel() {
+#ifdef BONUS_KERNELS_X86
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        bool sse42 = (info[2] & (1 << 20)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        bool avx2 = false;
+        if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        bool sse42 = __builtin_cpu_supports("sse4.2");
+        bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (avx2) return Level::AVX2;
+        if (sse42) return Level::SSE42;
+#endif
+        return Level::Scalar;
+    }
+
+    Level getLevel() {
+        return currentLevel().load();
+    }
+
+    void setLevel(Level level) {
+        currentLevel().store(min(level, detectLevel()));
+    }
+
+    const char* levelName(Level level) {
+        switch (level) {
+        case Level::AVX2: return "AVX2";
+        case Level::SSE42: return "SSE4.2";
+        default: return "scalar";
+        }
+    }
+
+    double totalKPI(double pc, double cq, double tw, double in) {
+        double total;
+        totalKPIScalar(&pc, &cq, &tw, &in, &total, 0, 1);
+        return total;
+    }
+
+    double bonus(double salary, double kpiScore, int experience,
+        double kpiCoeff, double expCoeff, double maxExpBonus) {
+        double result;
+        bonusScalar(&salary, &kpiScore, &experience, &result, 0, 1, kpiCoeff, expCoeff, maxExpBonus);
+        return result;
+    }
+
+    void totalKPI(const double* pc, const double* cq, const double* tw, const double* in,
+        double* total, size_t count) {
+        switch (currentLevel().load()) {
+#ifdef BONUS_KERNELS_X86
+        case Level::AVX2: totalKPIAVX2(pc, cq, tw, in, total, count); return;
+        case Level::SSE42: totalKPISSE42(pc, cq, tw, in, total, count); return;
+#endif
+        default: totalKPIScalar(pc, cq, tw, in, total, 0, count); return;
+        }
+    }
+
+    void bonus(const double* salary, const double* kpiScore, const int* experience,
+        double* bonus, size_t count, double kpiCoeff, double expCoeff, double maxExpBonus) {
+        switch (currentLevel().load()) {
+#ifdef BONUS_KERNELS_X86
+        case Level::AVX2: bonusAVX2(salary, kpiScore, experience, bonus, count, kpiCoeff, expCoeff, maxExpBonus); return;
+        case Level::SSE42: bonusSSE42(salary, kpiScore, experience, bonus, count, kpiCoeff, expCoeff, maxExpBonus); return;
+#endif
+        default: bonusScalar(salary, kpiScore, experience, bonus, 0, count, kpiCoeff, expCoeff, maxExpBonus); return;
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef BONUS_KERNELS_H
+#define BONUS_KERNELS_H
+
+#include <cstddef>
+
+namespace BonusKernels {
+    enum class Level { Scalar, SSE42, AVX2 };
+
+    Level detectLevel();
+    Level getLevel();
+    void setLevel(Level level);
+    const char* levelName(Level level);
+
+    double totalKPI(double pc, double cq, double tw, double in);
+    double bonus(double salary, double kpiScore, int experience,
+        double kpiCoeff, double expCoeff, double maxExpBonus);
+
+    void totalKPI(const double* pc, const double* cq, const double* tw, const double* in,
+        double* total, size_t count);
+    void bonus(const double* salary, const double* kpiScore, const int* experience,
+        double* bonus, size_t count, double kpiCoeff, double expCoeff, double maxExpBonus);
+}
+
+#endif
@@ -2,57 +2,148 @@
 #include "validation.h"
 #include "input.h"
 #include "table_format.h"
+#include "bonus_kernels.h"
+#include "journal.h"
+#include "data_loader.h"
+#include "snapshot.h"
+#include "what_if.h"
+#include "record_pool.h"
 #include <fstream>
+#include <filesystem>
 #include <algorithm>
 #include <conio.h>
 #include <locale.h>
 #include <iomanip>
 #include <stdexcept>
+#include <cmath>
+#include <charconv>
+#include <cstdint>
+#include <thread>
+#include <unordered_set>
 
 using namespace std;
 
-int User::userCount = 0;
-const int Date::MIN_YEAR = 1900;
+atomic<int> User::userCount(0);
+atomic<uint64_t> BonusFormula::versionCounter(0);
+const size_t PARALLEL_SORT_THRESHOLD = 50000;
+
+template<typename Compare>
+void sortRows(vector<size_t>& order, Compare compare) {
+    size_t parts = thread::hardware_concurrency();
+    if (order.size() < PARALLEL_SORT_THRESHOLD || parts < 2) {
+        sort(order.begin(), order.end(), compare);
+        return;
+    }
+
+    vector<size_t> bounds;
+    size_t chunk = (order.size() + parts - 1) / parts;
+    for (size_t i = 0; i < parts; i++) bounds.push_back(min(i * chunk, order.size()));
+    bounds.push_back(order.size());
+
+    vector<thread> workers;
+    for (size_t i = 0; i < parts; i++) {
+        workers.emplace_back([&order, &compare, begin = bounds[i], end = bounds[i + 1]]() {
+            sort(order.begin() + begin, order.begin() + end, compare);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    for (size_t width = 1; width < parts; width *= 2) {
+        workers.clear();
+        for (size_t i = 0; i + width < parts; i += 2 * width) {
+            size_t first = bounds[i], middle = bounds[i + width], last = bounds[min(i + 2 * width, parts)];
+            workers.emplace_back([&order, &compare, first, middle, last]() {
+                inplace_merge(order.begin() + first, order.begin() + middle, order.begin() + last, compare);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+    }
+}
 
 namespace Encryption {
-    string hashPassword(const string& password) {
-        string hashed = password;
+    string hashPassword(string_view password) {
+        string hashed(password);
         for (char& c : hashed) c ^= 0x55;
         return hashed;
     }
 
-    bool verifyPassword(const string& password, const string& hashedPassword) {
+    bool verifyPassword(string_view password, string_view hashedPassword) {
         return hashPassword(password) == hashedPassword;
     }
 }
 
-Date::Date(int d, int m, int y) : day(d), month(m), year(y) {}
+static_assert(Date::daysFromCivil(1970, 1, 1) == 0, "serial day 0 is 1970-01-01");
+static_assert(Date(29, 2, 2024).getDay() == 29 && Date(1, 3, 2024).serial() - Date(28, 2, 2024).serial() == 2,
+    "leap day round trip");
+static_assert(!Date::isValid(1, 1, Date::MAX_YEAR + 1) && Date::daysFromCivil(Date::MAX_YEAR, 12, 31) > 0,
+    "year range keeps serial arithmetic in range");
+
+size_t Date::format(char* buffer, size_t size) const {
+    Civil c = civil();
+    char* end = buffer + size;
+    char* cursor = to_chars(buffer, end, c.day).ptr;
+    if (cursor != end) *cursor++ = '.';
+    cursor = to_chars(cursor, end, c.month).ptr;
+    if (cursor != end) *cursor++ = '.';
+    cursor = to_chars(cursor, end, c.year).ptr;
+    return cursor - buffer;
+}
+
+bool Date::parse(string_view text, Date& date) {
+    int values[3];
+    const char* cursor = text.data();
+    const char* end = text.data() + text.size();
+    for (int i = 0; i < 3; i++) {
+        if (i > 0) {
+            if (cursor == end || *cursor != '.') return false;
+            cursor++;
+        }
+        auto result = from_chars(cursor, end, values[i]);
+        if (result.ec != errc()) return false;
+        cursor = result.ptr;
+    }
+    if (cursor != end || !isValid(values[0], values[1], values[2])) return false;
+
+    date = Date(values[0], values[1], values[2]);
+    return true;
+}
 
 string Date::toString() const {
-    return to_string(day) + "." + to_string(month) + "." + to_string(year);
+    char buffer[MAX_TEXT];
+    return string(buffer, format(buffer, sizeof(buffer)));
 }
 
 Date Date::fromString(const string& dateStr) {
-    int d, m, y;
-    char dot;
-    stringstream ss(dateStr);
-    ss >> d >> dot >> m >> dot >> y;
-    return Date(d, m, y);
+    Date date;
+    if (!parse(dateStr, date)) throw invalid_argument(" : " + dateStr);
+    return date;
 }
 
-int Date::calculateExperience() const {
+AsOfDate::AsOfDate(int y, int m, int d) : year(y), month(m), day(d) {}
+
+AsOfDate AsOfDate::today() {
     time_t now = time(0);
     tm currentTime;
     localtime_s(&currentTime, &now);
-    int currentYear = currentTime.tm_year + 1900;
-    int currentMonth = currentTime.tm_mon + 1;
-    int experience = currentYear - year;
-    if (currentMonth < month) experience--;
-    return max(0, experience);
+    return AsOfDate(currentTime.tm_year + 1900, currentTime.tm_mon + 1, currentTime.tm_mday);
+}
+
+int Date::calculateExperience() const {
+    return calculateExperience(AsOfDate::today());
+}
+
+int Date::calculateExperience(const AsOfDate& asOf) const {
+    return experienceBetween(monthIndex(), asOf.monthIndex());
+}
+
+int Date::experienceBetween(int hireMonthIndex, int asOfMonthIndex) {
+    int months = asOfMonthIndex - hireMonthIndex;
+    return months < 0 ? 0 : months / 12;
 }
 
 ostream& operator<<(ostream& os, const Date& date) {
-    os << date.day << "." << date.month << "." << date.year;
+    char buffer[Date::MAX_TEXT];
+    os.write(buffer, date.format(buffer, sizeof(buffer)));
     return os;
 }
 
@@ -60,7 +151,12 @@ KPI::KPI(double pc, double cq, double tw, double in)
     : projectCompletion(pc), codeQuality(cq), teamwork(tw), innovation(in) {}
 
 double KPI::getTotalKPI() const {
-    return (projectCompletion * 0.4 + codeQuality * 0.3 + teamwork * 0.2 + innovation * 0.1);
+    return BonusKernels::totalKPI(projectCompletion, codeQuality, teamwork, innovation);
+}
+
+void KPI::getTotalKPIBatch(const double* pc, const double* cq, const double* tw,
+    const double* in, double* total, size_t count) {
+    BonusKernels::totalKPI(pc, cq, tw, in, total, count);
 }
 
 double KPI::getProjectCompletion() const { return projectCompletion; }
@@ -81,20 +177,37 @@ string KPI::toString() const {
 }
 
 BonusFormula::BonusFormula(double kpiCoeff, double expCoeff, double maxExpBonus)
-    : kpiCoefficient(kpiCoeff), experienceCoefficient(expCoeff), maxExperienceBonus(maxExpBonus) {}
+    : kpiCoefficient(kpiCoeff), experienceCoefficient(expCoeff), maxExperienceBonus(maxExpBonus),
+    version(++versionCounter) {}
 
 double BonusFormula::getKpiCoefficient() const { return kpiCoefficient; }
 double BonusFormula::getExperienceCoefficient() const { return experienceCoefficient; }
 double BonusFormula::getMaxExperienceBonus() const { return maxExperienceBonus; }
 
-void BonusFormula::setKpiCoefficient(double coeff) { kpiCoefficient = coeff; }
-void BonusFormula::setExperienceCoefficient(double coeff) { experienceCoefficient = coeff; }
-void BonusFormula::setMaxExperienceBonus(double bonus) { maxExperienceBonus = bonus; }
+void BonusFormula::setKpiCoefficient(double coeff) {
+    kpiCoefficient = coeff;
+    version = ++versionCounter;
+}
+
+void BonusFormula::setExperienceCoefficient(double coeff) {
+    experienceCoefficient = coeff;
+    version = ++versionCounter;
+}
+
+void BonusFormula::setMaxExperienceBonus(double bonus) {
+    maxExperienceBonus = bonus;
+    version = ++versionCounter;
+}
 
 double BonusFormula::calculateBonus(double salary, double kpiScore, int experience) const {
-    double experienceBonus = min(experience * experienceCoefficient, maxExperienceBonus);
-    double kpiBonus = kpiScore / 100 * kpiCoefficient;
-    return salary * (kpiBonus + experienceBonus);
+    return BonusKernels::bonus(salary, kpiScore, experience,
+        kpiCoefficient, experienceCoefficient, maxExperienceBonus);
+}
+
+void BonusFormula::calculateBonusBatch(const double* salary, const double* kpiScore,
+    const int* experience, double* bonus, size_t count) const {
+    BonusKernels::bonus(salary, kpiScore, experience, bonus, count,
+        kpiCoefficient, experienceCoefficient, maxExperienceBonus);
 }
 
 void BonusFormula::displayFormula() const {
@@ -133,9 +246,12 @@ BonusFormula BonusFormula::getDefault() {
     return BonusFormula();
 }
 
-User::User(string uname, string pwd, string name, string r, bool approved)
-    : username(uname), fullName(name), role(r), isApproved(approved) {
-    setPassword(pwd);
+User::User(StringArena& arena, string_view uname, string_view pwd, string_view name, string_view r, bool approved)
+    : User(arena, uname, PasswordHash{ Encryption::hashPassword(pwd) }, name, r, approved) {}
+
+User::User(StringArena& arena, string_view uname, PasswordHash hash, string_view name, string_view r, bool approved)
+    : text(nullptr), strings(&arena.owner()), lengths(), isApproved(approved) {
+    storeFields(arena, uname, hash.value, name, r);
     userCount++;
 }
 
@@ -143,76 +259,142 @@ User::~User() {
     userCount--;
 }
 
-string User::getUsername() const { return username; }
-string User::getPassword() const { return password; }
-string User::getFullName() const { return fullName; }
-string User::getRole() const { return role; }
+void User::storeFields(StringArena& arena, string_view uname, string_view hash, string_view name, string_view r) {
+    string_view block = arena.store({ uname, hash, name, r });
+    text = block.data();
+    lengths[0] = (uint16_t)uname.size();
+    lengths[1] = (uint16_t)hash.size();
+    lengths[2] = (uint16_t)name.size();
+    lengths[3] = (uint16_t)r.size();
+}
+
 bool User::getIsApproved() const { return isApproved; }
 
-void User::setUsername(const string& uname) { username = uname; }
-void User::setPassword(const string& pwd) { password = Encryption::hashPassword(pwd); }
-void User::setFullName(const string& name) { fullName = name; }
-void User::setRole(const string& r) { role = r; }
+void User::setUsername(string_view uname) { storeFields(*strings, uname, getPassword(), getFullName(), getRole()); }
+void User::setPassword(string_view pwd) { setPasswordHash(Encryption::hashPassword(pwd)); }
+void User::setPasswordHash(string_view hash) { storeFields(*strings, getUsername(), hash, getFullName(), getRole()); }
+void User::setFullName(string_view name) { storeFields(*strings, getUsername(), getPassword(), name, getRole()); }
+void User::setRole(string_view r) { storeFields(*strings, getUsername(), getPassword(), getFullName(), r); }
 void User::setIsApproved(bool approved) { isApproved = approved; }
 
-bool User::verifyPassword(const string& pwd) const {
-    return Encryption::verifyPassword(pwd, password);
+bool User::verifyPassword(string_view pwd) const {
+    return Encryption::verifyPassword(pwd, getPassword());
 }
 
 int User::getUserCount() {
     return userCount;
 }
 
-Employee::Employee(string uname, string pwd, string name,
-    string dept, string pos, double sal, Date hire)
-    : User(uname, pwd, name, "user", true), department(dept), position(pos),
-    salary(sal), hireDate(hire) {}
+Employee::Employee(StringArena& arena, string_view uname, string_view pwd, string_view name,
+    string_view dept, string_view pos, double sal, Date hire)
+    : Employee(arena, uname, pwd, name, StringDictionary::departments().intern(dept),
+        StringDictionary::positions().intern(pos), sal, hire) {}
+
+Employee::Employee(StringArena& arena, string_view uname, string_view pwd, string_view name,
+    uint32_t deptId, uint32_t posId, double sal, Date hire)
+    : Employee(arena, uname, PasswordHash{ Encryption::hashPassword(pwd) }, name, deptId, posId, sal, hire) {}
+
+Employee::Employee(StringArena& arena, string_view uname, PasswordHash hash, string_view name,
+    uint32_t deptId, uint32_t posId, double sal, Date hire)
+    : User(arena, uname, hash, name, "user", true), cacheBusy(false), kpiHundredths(), hireDate(hire.serial()),
+    departmentId(deptId), positionId(posId), salaryMinor(llround(sal * SALARY_SCALE)), version(1),
+    cachedVersion(0), cachedFormulaVersion(0), cachedAsOfMonth(0), cachedBonus(0) {}
+
+const string& Employee::getDepartment() const { return StringDictionary::departments().name(departmentId); }
+const string& Employee::getPosition() const { return StringDictionary::positions().name(positionId); }
+double Employee::getSalary() const { return (double)salaryMinor / SALARY_SCALE; }
+Date Employee::getHireDate() const { return Date::fromSerial(hireDate); }
+
+KPI Employee::getKPI() const {
+    return KPI((double)kpiHundredths[0] / KPI_SCALE, (double)kpiHundredths[1] / KPI_SCALE,
+        (double)kpiHundredths[2] / KPI_SCALE, (double)kpiHundredths[3] / KPI_SCALE);
+}
+
+void Employee::setDepartment(string_view dept) { departmentId = StringDictionary::departments().intern(dept); }
+void Employee::setPosition(string_view pos) { positionId = StringDictionary::positions().intern(pos); }
+void Employee::setSalary(double sal) {
+    salaryMinor = llround(sal * SALARY_SCALE);
+    version++;
+}
 
-string Employee::getDepartment() const { return department; }
-string Employee::getPosition() const { return position; }
-double Employee::getSalary() const { return salary; }
-Date Employee::getHireDate() const { return hireDate; }
-KPI Employee::getKPI() const { return kpi; }
+void Employee::setHireDate(Date hire) {
+    hireDate = hire.serial();
+    version++;
+}
 
-void Employee::setDepartment(const string& dept) { department = dept; }
-void Employee::setPosition(const string& pos) { position = pos; }
-void Employee::setSalary(double sal) { salary = sal; }
-void Employee::setHireDate(Date hire) { hireDate = hire; }
-void Employee::setKPI(const KPI& k) { kpi = k; }
+void Employee::setKPI(const KPI& k) {
+    for (int i = 0; i < 4; i++) {
+        kpiHundredths[i] = (uint16_t)lround(k[i] * KPI_SCALE);
+    }
+    version++;
+}
 
 double Employee::calculateBonus(const BonusFormula& formula) const {
-    double kpiScore = kpi.getTotalKPI();
-    int experience = hireDate.calculateExperience();
-    return formula.calculateBonus(salary, kpiScore, experience);
+    return calculateBonus(formula, AsOfDate::today());
+}
+
+double Employee::calculateBonus(const BonusFormula& formula, const AsOfDate& asOf) const {
+    bool owner = !cacheBusy.exchange(true, memory_order_acquire);
+    if (owner && cachedVersion == version && cachedFormulaVersion == (uint32_t)formula.getVersion() &&
+        cachedAsOfMonth == asOf.monthIndex()) {
+        double bonus = cachedBonus;
+        cacheBusy.store(false, memory_order_release);
+        return bonus;
+    }
+
+    double kpiScore = getKPI().getTotalKPI();
+    int experience = getHireDate().calculateExperience(asOf);
+    double bonus = formula.calculateBonus(getSalary(), kpiScore, experience);
+    if (owner) {
+        cachedBonus = bonus;
+        cachedVersion = version;
+        cachedFormulaVersion = (uint32_t)formula.getVersion();
+        cachedAsOfMonth = asOf.monthIndex();
+        cacheBusy.store(false, memory_order_release);
+    }
+    return bonus;
 }
 
 int Employee::getExperience() const {
-    return hireDate.calculateExperience();
+    return getHireDate().calculateExperience();
+}
+
+int Employee::getExperience(const AsOfDate& asOf) const {
+    return getHireDate().calculateExperience(asOf);
 }
 
 string Employee::toFileString() const {
-    return username + "," + password + "," + fullName + "," + role + ",1," +
-        department + "," + position + "," + to_string((int)salary) + "," +
-        hireDate.toString() + "," + to_string((int)kpi.getProjectCompletion()) + "," +
-        to_string((int)kpi.getCodeQuality()) + "," + to_string((int)kpi.getTeamwork()) + "," +
-        to_string((int)kpi.getInnovation());
+    KPI kpi = getKPI();
+    string line;
+    line.reserve(128);
+    line.append(getUsername()).append(",");
+    DataLoader::appendEscaped(line, getPassword());
+    line.append(",").append(getFullName())
+        .append(",").append(getRole()).append(",1,").append(getDepartment()).append(",")
+        .append(getPosition()).append(",").append(to_string((int)getSalary())).append(",")
+        .append(getHireDate().toString());
+    for (int i = 0; i < 4; i++) {
+        line.append(",").append(to_string((int)kpi[i]));
+    }
+    return line;
 }
 
-void Employee::displayDetailedInfo(const BonusFormula& formula) const {
+void Employee::displayDetailedInfo(const BonusFormula& formula, const AsOfDate& asOf) const {
     cout << "\n--     --" << endl;
-    cout << ": " << fullName << endl;
-    cout << ": " << username << endl;
-    cout << ": " << department << endl;
-    cout << ": " << position << endl;
-    cout << ": " << salary << " BYN" << endl;
-    cout << " : " << hireDate.toString() << endl;
-    cout << ": " << getExperience() << " " << endl;
+    cout << ": " << getFullName() << endl;
+    cout << ": " << getUsername() << endl;
+    cout << ": " << getDepartment() << endl;
+    cout << ": " << getPosition() << endl;
+    cout << ": " << getSalary() << " BYN" << endl;
+    cout << " : " << getHireDate().toString() << endl;
+    cout << ": " << getExperience(asOf) << " " << endl;
+    KPI kpi = getKPI();
     cout << "KPI: " << kpi.toString() << endl;
     cout << " KPI: " << (int)kpi.getTotalKPI() << "%" << endl;
-    cout << " : " << calculateBonus(formula) << " BYN" << endl;
+    cout << " : " << calculateBonus(formula, asOf) << " BYN" << endl;
 }
 
-void Employee::showMenu() {
+void Employee::showMenu(const StoreLock& lock) {
     BonusFormula defaultFormula;
     int choice;
     do {
@@ -225,14 +407,15 @@ void Employee::showMenu() {
 
         choice = getIntInput("", 0, 3);
 
+        StoreLock::ReadGuard guard = lock.read();
         switch (choice) {
         case 1:
-            displayDetailedInfo(defaultFormula);
+            displayDetailedInfo(defaultFormula, AsOfDate::today());
             break;
         case 2:
             cout << "\n--  KPI --" << endl;
-            cout << kpi.toString() << endl;
-            cout << " : " << (int)kpi.getTotalKPI() << "%" << endl;
+            cout << getKPI().toString() << endl;
+            cout << " : " << (int)getKPI().getTotalKPI() << "%" << endl;
             break;
         case 3:
             cout << "\n--   --" << endl;
@@ -245,17 +428,242 @@ void Employee::showMenu() {
     } while (choice != 0);
 }
 
-Admin::Admin(string uname, string pwd, string name)
-    : User(uname, pwd, name, "admin", true) {}
+double VersionRow::totalKPI() const {
+    return BonusKernels::totalKPI(kpiValue(0), kpiValue(1), kpiValue(2), kpiValue(3));
+}
+
+StoreVersion::StoreVersion(vector<shared_ptr<const vector<VersionRow>>> rowChunks,
+    vector<shared_ptr<const vector<uint32_t>>> departmentRows, size_t rows, uint64_t number,
+    const BonusFormula& f, const AsOfDate& date, bool pinned, PayrollSummary stats,
+    shared_ptr<const StringArena> arena)
+    : chunks(move(rowChunks)), departments(move(departmentRows)), rowCount(rows), versionNumber(number), formula(f), asOf(date),
+    asOfPinned(pinned), summary(move(stats)), strings(move(arena)) {}
+
+const vector<uint32_t>& StoreVersion::departmentRows(uint32_t departmentId) const {
+    static const vector<uint32_t> noRows;
+    return departmentId < departments.size() ? *departments[departmentId] : noRows;
+}
+
+shared_ptr<const VersionColumns> StoreVersion::columns() const {
+    lock_guard<mutex> lock(derivedMutex);
+    if (derived) return derived;
+
+    auto result = make_shared<VersionColumns>();
+    vector<double> pc(rowCount), cq(rowCount), tw(rowCount), in(rowCount);
+    result->salary.resize(rowCount);
+    result->totalKPI.resize(rowCount);
+    result->experience.resize(rowCount);
+    result->bonus.resize(rowCount);
+
+    int asOfMonth = asOf.monthIndex();
+    for (size_t i = 0; i < rowCount; i++) {
+        const VersionRow& row = (*this)[i];
+        result->salary[i] = row.salary;
+        pc[i] = row.kpiValue(0);
+        cq[i] = row.kpiValue(1);
+        tw[i] = row.kpiValue(2);
+        in[i] = row.kpiValue(3);
+        result->experience[i] = Date::experienceBetween(row.hireMonth(), asOfMonth);
+    }
+    KPI::getTotalKPIBatch(pc.data(), cq.data(), tw.data(), in.data(), result->totalKPI.data(), rowCount);
+    formula.calculateBonusBatch(result->salary.data(), result->totalKPI.data(),
+        result->experience.data(), result->bonus.data(), rowCount);
+
+    derived = result;
+    return derived;
+}
+
+VersionBuilder::VersionBuilder() : rowCount(0), nextNumber(1) {}
+
+VersionRow& VersionBuilder::writable(size_t row) {
+    size_t chunk = row / StoreVersion::CHUNK_ROWS;
+    if (shared[chunk]) {
+        chunks[chunk] = make_shared<vector<VersionRow>>(*chunks[chunk]);
+        shared[chunk] = false;
+    }
+    return (*chunks[chunk])[row % StoreVersion::CHUNK_ROWS];
+}
+
+void VersionBuilder::append(const VersionRow& row) {
+    if (rowCount % StoreVersion::CHUNK_ROWS == 0) {
+        chunks.push_back(make_shared<vector<VersionRow>>());
+        chunks.back()->reserve(StoreVersion::CHUNK_ROWS);
+        shared.push_back(false);
+    }
+    else if (shared.back()) {
+        auto copy = make_shared<vector<VersionRow>>();
+        copy->reserve(StoreVersion::CHUNK_ROWS);
+        copy->assign(chunks.back()->begin(), chunks.back()->end());
+        chunks.back() = copy;
+        shared.back() = false;
+    }
+    chunks.back()->push_back(row);
+    rowCount++;
+}
+
+void VersionBuilder::assign(size_t row, const VersionRow& value) {
+    writable(row) = value;
+}
+
+void VersionBuilder::erase(size_t row) {
+    size_t last = rowCount - 1;
+    if (row != last) writable(row) = (*chunks[last / StoreVersion::CHUNK_ROWS])[last % StoreVersion::CHUNK_ROWS];
+
+    size_t chunk = last / StoreVersion::CHUNK_ROWS;
+    if (last % StoreVersion::CHUNK_ROWS == 0) {
+        chunks.pop_back();
+        shared.pop_back();
+    }
+    else {
+        if (shared[chunk]) {
+            chunks[chunk] = make_shared<vector<VersionRow>>(chunks[chunk]->begin(), chunks[chunk]->end() - 1);
+            shared[chunk] = false;
+        }
+        else {
+            chunks[chunk]->pop_back();
+        }
+    }
+    rowCount--;
+}
+
+void VersionBuilder::clear() {
+    chunks.clear();
+    shared.clear();
+    rowCount = 0;
+}
+
+size_t VersionBuilder::memoryBytes() const {
+    size_t bytes = chunks.capacity() * sizeof(chunks[0]) + shared.capacity();
+    for (const auto& chunk : chunks) {
+        bytes += chunk->capacity() * sizeof(VersionRow) + sizeof(vector<VersionRow>) + 2 * sizeof(void*);
+    }
+    return bytes;
+}
+
+shared_ptr<const StoreVersion> VersionBuilder::publish(const BonusFormula& formula, const AsOfDate& asOf,
+    bool asOfPinned, PayrollSummary summary, shared_ptr<const StringArena> strings,
+    vector<shared_ptr<const vector<uint32_t>>> departmentRows) {
+    vector<shared_ptr<const vector<VersionRow>>> frozen(chunks.begin(), chunks.end());
+    fill(shared.begin(), shared.end(), true);
+    return make_shared<const StoreVersion>(move(frozen), move(departmentRows), rowCount, nextNumber++, formula, asOf, asOfPinned,
+        move(summary), move(strings));
+}
+
+Admin::Admin(StringArena& arena, string_view uname, string_view pwd, string_view name)
+    : User(arena, uname, pwd, name, "admin", true) {}
 
 void Admin::showMenu() {}
 
 string Admin::toFileString() const {
-    return username + "," + password + "," + fullName + "," + role + ",1,2024-01-01";
+    string line;
+    line.append(getUsername()).append(",");
+    DataLoader::appendEscaped(line, getPassword());
+    line.append(",").append(getFullName()).append(",").append(getRole()).append(",1,2024-01-01");
+    return line;
+}
+
+UsernameIndex::UsernameIndex(const Repository<shared_ptr<Employee>>& records, const shared_ptr<Admin>& administrator)
+    : employees(records), admin(administrator), slots(16), count(0), occupied(0) {}
+
+uint32_t UsernameIndex::hashKey(string_view key) {
+    uint32_t hash = 2166136261U;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+string_view UsernameIndex::keyOf(uint32_t id) const {
+    return id == ADMIN_ID ? admin->getUsername() : employees.atSlot(id)->getUsername();
+}
+
+size_t UsernameIndex::findSlot(string_view key, uint32_t hash) const {
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    size_t firstDeleted = slots.size();
+    while (true) {
+        const Slot& slot = slots[i];
+        if (slot.id == EMPTY) {
+            return firstDeleted != slots.size() ? firstDeleted : i;
+        }
+        if (slot.id == DELETED) {
+            if (firstDeleted == slots.size()) firstDeleted = i;
+        }
+        else if (slot.hash == hash && keyOf(slot.id) == key) {
+            return i;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+void UsernameIndex::rehash(size_t newCapacity) {
+    vector<Slot> old(newCapacity);
+    old.swap(slots);
+    occupied = count;
+    size_t mask = slots.size() - 1;
+    for (const auto& slot : old) {
+        if (slot.id == EMPTY || slot.id == DELETED) continue;
+        size_t i = slot.hash & mask;
+        while (slots[i].id != EMPTY) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+bool UsernameIndex::insert(string_view username, uint32_t id) {
+    if ((occupied + 1) * 10 > slots.size() * 7) {
+        rehash(count * 10 > slots.size() * 3 ? slots.size() * 2 : slots.size());
+    }
+
+    uint32_t hash = hashKey(username);
+    Slot& slot = slots[findSlot(username, hash)];
+    if (slot.id != EMPTY && slot.id != DELETED) return false;
+
+    if (slot.id == EMPTY) occupied++;
+    slot.hash = hash;
+    slot.id = id;
+    count++;
+    return true;
+}
+
+bool UsernameIndex::erase(string_view username) {
+    Slot& slot = slots[findSlot(username, hashKey(username))];
+    if (slot.id == EMPTY || slot.id == DELETED) return false;
+
+    slot.id = DELETED;
+    count--;
+    return true;
+}
+
+optional<UserRecord> UsernameIndex::find(string_view username) const {
+    const Slot& slot = slots[findSlot(username, hashKey(username))];
+    if (slot.id == EMPTY || slot.id == DELETED) return nullopt;
+    if (slot.id == ADMIN_ID) return UserRecord(admin);
+    return UserRecord(employees.atSlot(slot.id));
+}
+
+bool UsernameIndex::contains(string_view username) const {
+    uint32_t id = slots[findSlot(username, hashKey(username))].id;
+    return id != EMPTY && id != DELETED;
+}
+
+void UsernameIndex::reserve(size_t users) {
+    size_t capacity = slots.size();
+    while ((users + 1) * 10 > capacity * 7) capacity *= 2;
+    if (capacity != slots.size()) rehash(capacity);
+}
+
+void UsernameIndex::clear() {
+    slots.assign(16, Slot());
+    count = 0;
+    occupied = 0;
 }
 
 BonusSystem::BonusSystem(string filename, string formulaFilename)
-    : dataFile(filename), formulaFile(formulaFilename) {
+    : strings(make_shared<StringArena>()), dataFile(filename), formulaFile(formulaFilename), snapshotFile(filename + ".bin"),
+    asOfPinned(false), pinnedAsOf(AsOfDate::today()), usernameIndex(employees, admin), journal(filename + ".journal"),
+    nameIndexValid(false), aggregatesValid(false), aggregatesFormulaVersion(0), aggregatesMonth(0),
+    payrollModelValid(false), payrollModelMonth(0) {
     createDefaultAdmin();
     loadFormula();
     loadData();
@@ -267,14 +675,279 @@ BonusSystem::~BonusSystem() {
 }
 
 void BonusSystem::createDefaultAdmin() {
-    users.push_back(make_shared<Admin>());
+    StoreLock::WriteGuard guard = storeLock.write();
+    admin = make_shared<Admin>(*strings);
+    usernameIndex.insert(admin->getUsername(), UsernameIndex::ADMIN_ID);
+}
+
+void BonusSystem::attachEmployee(shared_ptr<Employee> emp) {
+    Handle handle = employees.add(move(emp));
+    usernameIndex.insert(employees.atSlot(handle.slot)->getUsername(), handle.slot);
+    versions.append(versionRow(employees.size() - 1));
+    indexRow(employees.size() - 1);
+}
+
+void BonusSystem::detachEmployee(size_t index) {
+    size_t last = employees.size() - 1;
+    VersionRow removed = versions.row(index);
+    unindexRow(index, removed);
+    if (index != last) {
+        //      :      .
+        uint32_t department = versions.row(last).departmentId;
+        if (nameIndexValid) {
+            string key = nameKey(last);
+            nameIndex.remove(last, key);
+            nameIndex.add(index, key);
+        }
+        departments.remove(last, department);
+        departments.add(index, department);
+    }
+    usernameIndex.erase(removed.username());
+    employees.remove(employees.handleAt(index));
+    versions.erase(index);
+}
+
+string BonusSystem::nameKey(size_t row) const {
+    return toLowerRussian(versions.row(row).fullName());
+}
+
+void BonusSystem::indexRow(size_t row) {
+    const VersionRow& entry = versions.row(row);
+    if (nameIndexValid) nameIndex.add(row, nameKey(row));
+    departments.add(row, entry.departmentId);
+
+    if (aggregatesValid && formula.getVersion() == aggregatesFormulaVersion) {
+        aggregates.add(entry.departmentId, entry.salary, rowBonus(entry, aggregatesMonth), entry.totalKPI(),
+            entry.fullName());
+    }
+    else {
+        aggregatesValid = false;
+    }
+
+    if (payrollModelValid) {
+        payrollModel.add(entry.departmentId, entry.salary, entry.totalKPI(),
+            Date::experienceBetween(entry.hireMonth(), payrollModelMonth));
+    }
+}
+
+//         :     .
+void BonusSystem::unindexRow(size_t row, const VersionRow& old) {
+    if (nameIndexValid) nameIndex.remove(row, toLowerRussian(old.fullName()));
+    departments.remove(row, old.departmentId);
+
+    if (aggregatesValid && formula.getVersion() == aggregatesFormulaVersion) {
+        aggregates.remove(old.departmentId, old.salary, rowBonus(old, aggregatesMonth), old.totalKPI());
+    }
+    else {
+        aggregatesValid = false;
+    }
+
+    if (payrollModelValid) {
+        payrollModel.remove(old.departmentId, old.salary, old.totalKPI(),
+            Date::experienceBetween(old.hireMonth(), payrollModelMonth));
+    }
+}
+
+double BonusSystem::rowBonus(const VersionRow& row, int asOfMonth) const {
+    return formula.calculateBonus(row.salary, row.totalKPI(), Date::experienceBetween(row.hireMonth(), asOfMonth));
+}
+
+void BonusSystem::rowBonuses(size_t first, size_t count, int asOfMonth, double* bonus, double* totalKPI) const {
+    double salary[StoreVersion::CHUNK_ROWS], pc[StoreVersion::CHUNK_ROWS], cq[StoreVersion::CHUNK_ROWS];
+    double tw[StoreVersion::CHUNK_ROWS], in[StoreVersion::CHUNK_ROWS];
+    int experience[StoreVersion::CHUNK_ROWS];
+    for (size_t i = 0; i < count; i++) {
+        const VersionRow& row = versions.row(first + i);
+        salary[i] = row.salary;
+        pc[i] = row.kpiValue(0);
+        cq[i] = row.kpiValue(1);
+        tw[i] = row.kpiValue(2);
+        in[i] = row.kpiValue(3);
+        experience[i] = Date::experienceBetween(row.hireMonth(), asOfMonth);
+    }
+    KPI::getTotalKPIBatch(pc, cq, tw, in, totalKPI, count);
+    formula.calculateBonusBatch(salary, totalKPI, experience, bonus, count);
+}
+
+void BonusSystem::ensureAggregates(const AsOfDate& asOf) {
+    int month = asOf.monthIndex();
+    if (aggregatesValid && formula.getVersion() == aggregatesFormulaVersion && aggregatesMonth == month) {
+        //         ,   .
+        for (uint32_t id = 0; id < aggregates.departmentCount(); id++) {
+            if (!aggregates.extremesStale(id)) continue;
+            aggregates.resetExtremes(id);
+            for (uint32_t row : departments.rowsOf(id)) {
+                const VersionRow& entry = versions.row(row);
+                aggregates.offerExtreme(id, rowBonus(entry, month), entry.fullName());
+            }
+        }
+        return;
+    }
+
+    aggregates.clear();
+    double bonus[StoreVersion::CHUNK_ROWS], totalKPI[StoreVersion::CHUNK_ROWS];
+    for (size_t first = 0; first < versions.size(); first += StoreVersion::CHUNK_ROWS) {
+        size_t count = min(StoreVersion::CHUNK_ROWS, versions.size() - first);
+        rowBonuses(first, count, month, bonus, totalKPI);
+        for (size_t i = 0; i < count; i++) {
+            const VersionRow& entry = versions.row(first + i);
+            aggregates.add(entry.departmentId, entry.salary, bonus[i], totalKPI[i], entry.fullName());
+        }
+    }
+    aggregatesFormulaVersion = formula.getVersion();
+    aggregatesMonth = month;
+    aggregatesValid = true;
+}
+
+void BonusSystem::ensurePayrollModel(const AsOfDate& asOf) {
+    if (payrollModelValid && payrollModelMonth == asOf.monthIndex()) {
+        return;
+    }
+
+    payrollModel.clear();
+    int month = asOf.monthIndex();
+    for (size_t row = 0; row < versions.size(); row++) {
+        const VersionRow& entry = versions.row(row);
+        payrollModel.add(entry.departmentId, entry.salary, entry.totalKPI(),
+            Date::experienceBetween(entry.hireMonth(), month));
+    }
+    payrollModelMonth = month;
+    payrollModelValid = true;
+}
+
+void BonusSystem::buildNameIndex() {
+    nameIndex.clear();
+    for (size_t row = 0; row < versions.size(); row++) {
+        nameIndex.add(row, nameKey(row));
+    }
+    nameIndex.shrink();
+    nameIndexValid = true;
+}
+
+PayrollForecast BonusSystem::forecastPayroll(const BonusFormula& candidate) {
+    StoreLock::ReadGuard guard = readDerived(Derived::PayrollModel);
+    return payrollModel.forecast(candidate);
+}
+
+void BonusSystem::showPayrollForecast() {
+    StoreLock::ReadGuard guard = readDerived(Derived::PayrollModel);
+    PayrollForecast forecast = payrollModel.forecast(formula);
+    cout << "    : " << forecast.total << " BYN" << endl;
+    for (uint32_t id = 0; id < forecast.departments.size(); id++) {
+        if (departments.rowsOf(id).empty()) continue;
+        cout << " " << departments.name(id) << ": " << forecast.departments[id] << " BYN" << endl;
+    }
+}
+
+void BonusSystem::syncRow(size_t row) {
+    unindexRow(row, versions.row(row));
+    versions.assign(row, versionRow(row));
+    indexRow(row);
+}
+
+StoreLock::EditGuard BonusSystem::lockEmployee(Handle handle, optional<uint32_t> moveTo) {
+    while (true) {
+        uint32_t department = 0;
+        {
+            StoreLock::ReadGuard guard = storeLock.read();
+            if (employees.contains(handle)) department = versions.row(employees.indexOf(handle)).departmentId;
+        }
+
+        StoreLock::EditGuard guard = storeLock.edit(department, moveTo.value_or(department));
+        lock_guard<mutex> commit(commitMutex);
+        //   ,       -   .
+        if (!employees.contains(handle) || versions.row(employees.indexOf(handle)).departmentId == department) {
+            return guard;
+        }
+    }
+}
+
+void BonusSystem::commitRow(Handle handle) {
+    lock_guard<mutex> commit(commitMutex);
+    syncRow(employees.indexOf(handle));
+    publishVersion();
+}
+
+bool BonusSystem::hasEmployees() const {
+    StoreLock::ReadGuard guard = storeLock.read();
+    return !employees.empty();
+}
+
+bool BonusSystem::derivedFresh(Derived need, const AsOfDate& asOf) const {
+    switch (need) {
+    case Derived::NameIndex:
+        return nameIndexValid;
+    case Derived::PayrollModel:
+        return payrollModelValid && payrollModelMonth == asOf.monthIndex();
+    }
+    return false;
+}
+
+StoreLock::ReadGuard BonusSystem::readDerived(Derived need) {
+    while (true) {
+        {
+            StoreLock::ReadGuard guard = storeLock.read();
+            if (derivedFresh(need, currentAsOf())) return guard;
+        }
+
+        StoreLock::WriteGuard guard = storeLock.write();
+        if (need == Derived::PayrollModel) {
+            ensurePayrollModel(currentAsOf());
+        }
+        else {
+            buildNameIndex();
+        }
+    }
+}
+
+VersionRow BonusSystem::versionRow(size_t row) const {
+    const Employee& emp = *employees[row];
+    VersionRow result;
+    result.handle = employees.handleAt(row);
+    result.text = emp.getUsername().data();
+    result.usernameLength = (uint16_t)emp.getUsername().size();
+    result.nameOffset = (uint32_t)(emp.getFullName().data() - result.text);
+    result.nameLength = (uint16_t)emp.getFullName().size();
+    result.departmentId = emp.getDepartmentId();
+    result.positionId = emp.getPositionId();
+    result.salary = emp.getSalary();
+    copy(emp.getKPIHundredths(), emp.getKPIHundredths() + 4, result.kpi);
+    result.hireDay = emp.getHireDate().serial();
+    return result;
+}
+
+void BonusSystem::publishVersion() {
+    AsOfDate asOf = currentAsOf();
+    ensureAggregates(asOf);
+    shared_ptr<const StoreVersion> version = versions.publish(formula, asOf, asOfPinned, aggregates.summary(), strings,
+        departments.freeze());
+    lock_guard<mutex> lock(publishedMutex);
+    published = move(version);
+}
+
+shared_ptr<const StoreVersion> BonusSystem::pinVersion() {
+    shared_ptr<const StoreVersion> version;
+    {
+        lock_guard<mutex> lock(publishedMutex);
+        version = published;
+    }
+    if (version->isAsOfPinned() || version->getAsOf().monthIndex() == AsOfDate::today().monthIndex()) {
+        return version;
+    }
+
+    StoreLock::WriteGuard guard = storeLock.write();
+    publishVersion();
+    lock_guard<mutex> lock(publishedMutex);
+    return published;
 }
 
 void BonusSystem::loadFormula() {
+    StoreLock::WriteGuard guard = storeLock.write();
     ifstream file(formulaFile);
     if (!file.is_open()) {
         cout << "    .    ." << endl;
         formula = BonusFormula();
+        publishVersion();
         return;
     }
 
@@ -284,9 +957,15 @@ void BonusSystem::loadFormula() {
         formula = BonusFormula::fromString(line);
     }
     file.close();
+    publishVersion();
 }
 
 void BonusSystem::saveFormula() {
+    StoreLock::WriteGuard guard = storeLock.write();
+    writeFormula();
+}
+
+void BonusSystem::writeFormula() {
     ofstream file(formulaFile);
     file << formula.toString();
     file.close();
@@ -295,78 +974,199 @@ void BonusSystem::saveFormula() {
 
 BonusFormula& BonusSystem::getFormula() { return formula; }
 
+AsOfDate BonusSystem::currentAsOf() const {
+    return asOfPinned ? pinnedAsOf : AsOfDate::today();
+}
+
+void BonusSystem::setAsOfDate(const AsOfDate& asOf) {
+    StoreLock::WriteGuard guard = storeLock.write();
+    pinnedAsOf = asOf;
+    asOfPinned = true;
+    publishVersion();
+}
+
+void BonusSystem::resetAsOfDate() {
+    StoreLock::WriteGuard guard = storeLock.write();
+    asOfPinned = false;
+    publishVersion();
+}
+
 void BonusSystem::loadData() {
-    ifstream file(dataFile);
-    if (!file.is_open()) {
-        cout << "   .     ." << endl;
-        return;
+    StoreLock::WriteGuard guard = storeLock.write();
+    vector<shared_ptr<Employee>> loaded;
+    vector<LoadError> errors;
+    bool fromSnapshot = Snapshot::read(snapshotFile, dataFile, loaded, *strings, &employeePool);
+    if (!fromSnapshot) {
+        LoadResult result = DataLoader::loadFile(dataFile, *strings, &employeePool);
+        if (!result.fileFound) {
+            cout << "   .     ." << endl;
+            publishVersion();
+            return;
+        }
+        loaded.swap(result.employees);
+        errors.swap(result.errors);
     }
 
-    string line;
-    while (getline(file, line)) {
-        if (line.empty()) continue;
+    //    ,     .
+    employees.reserve(employees.size() + loaded.size());
+    usernameIndex.reserve(usernameIndex.size() + loaded.size());
+    for (auto& emp : loaded) {
+        if (!usernameIndex.contains(emp->getUsername())) {
+            attachEmployee(move(emp));
+        }
+    }
+    vector<shared_ptr<Employee>>().swap(loaded);
+
+    if (!fromSnapshot) {
+        reportLoadErrors(errors);
+        //      ,   :        .
+        if (errors.empty()) {
+            Snapshot::write(snapshotFile, dataFile, [this](const Snapshot::EmployeeVisitor& visit) {
+                for (const auto& emp : employees) visit(*emp);
+            }, Snapshot::Image::Loaded);
+        }
+    }
 
-        vector<string> tokens;
-        string token;
-        stringstream ss(line);
+    replayJournal();
+    publishVersion();
+}
+
+void BonusSystem::reportLoadErrors(const vector<LoadError>& errors) {
+    for (const auto& error : errors) {
+        cout << "   ,  " << error.line << ": " << error.message << endl;
+    }
+    if (!errors.empty()) {
+        cout << " : " << errors.size() << ".        ." << endl;
+    }
+}
 
-        while (getline(ss, token, ',')) {
-            tokens.push_back(token);
+void BonusSystem::replayJournal() {
+    vector<ChangeRecord> records = journal.load();
+    if (records.empty()) return;
+
+    unordered_set<const User*> removed;
+    for (const auto& record : records) {
+        const vector<string>& f = record.fields;
+        if (record.type == ChangeType::Add) {
+            string error;
+            auto emp = DataLoader::parseEmployee(record.payload, error, *strings, &employeePool);
+            if (emp && !usernameIndex.contains(emp->getUsername())) {
+                attachEmployee(emp);
+            }
+            continue;
         }
 
-        if (tokens.size() >= 5) {
-            string username = tokens[0];
-            string password = tokens[1];
-            string fullName = tokens[2];
-            string role = tokens[3];
-            bool approved = (tokens[4] == "1");
+        if (f.empty()) continue;
+        optional<UserRecord> found = usernameIndex.find(f[0]);
+        const shared_ptr<Employee>* match = found ? get_if<shared_ptr<Employee>>(&*found) : nullptr;
+        if (!match) continue;
+        shared_ptr<Employee> emp = *match;
 
-            if (role == "admin") {
-                continue;
-            }
-            else if (tokens.size() >= 10) {
-                auto emp = make_shared<Employee>(username, "", fullName);
-                emp->setPassword(password);
-                emp->setIsApproved(approved);
-                emp->setDepartment(tokens[5]);
-                emp->setPosition(tokens[6]);
-                emp->setSalary(stod(tokens[7]));
-                emp->setHireDate(Date::fromString(tokens[8]));
-
-                KPI kpi(stod(tokens[9]), stod(tokens[10]), stod(tokens[11]), stod(tokens[12]));
-                emp->setKPI(kpi);
-
-                employees.push_back(emp);
-                users.push_back(emp);
+        switch (record.type) {
+        case ChangeType::Delete:
+            usernameIndex.erase(f[0]);
+            removed.insert(emp.get());
+            break;
+        case ChangeType::SetName:
+            if (f.size() >= 2) emp->setFullName(f[1]);
+            break;
+        case ChangeType::SetKPI: {
+            double kpi[4];
+            bool valid = f.size() == 5;
+            for (int i = 0; valid && i < 4; i++) valid = DataLoader::parseNumber(f[1 + i], kpi[i]);
+            if (valid) emp->setKPI(KPI(kpi[0], kpi[1], kpi[2], kpi[3]));
+            break;
+        }
+        case ChangeType::SetSalary: {
+            double salary;
+            if (f.size() == 2 && DataLoader::parseNumber(f[1], salary)) emp->setSalary(salary);
+            break;
+        }
+        case ChangeType::SetHireDate: {
+            Date hireDate;
+            if (f.size() == 2 && Date::parse(f[1], hireDate)) emp->setHireDate(hireDate);
+            break;
+        }
+        case ChangeType::SetPosition:
+            if (f.size() >= 3) {
+                emp->setDepartment(f[1]);
+                emp->setPosition(f[2]);
             }
+            break;
+        default:
+            break;
         }
     }
-    file.close();
+
+    for (size_t i = employees.size(); i-- > 0 && !removed.empty();) {
+        if (removed.count(employees[i].get())) employees.remove(employees.handleAt(i));
+    }
+    rebuildRows();
+}
+
+void BonusSystem::rebuildRows() {
+    nameIndex.clear();
+    nameIndexValid = false;
+    departments.clear();
+    aggregatesValid = false;
+    payrollModelValid = false;
+    versions.clear();
+    for (size_t row = 0; row < employees.size(); row++) {
+        versions.append(versionRow(row));
+        indexRow(row);
+    }
+}
+
+void BonusSystem::compactJournalIfNeeded() {
+    if (journal.needsCompaction()) {
+        writeData();
+    }
 }
 
 void BonusSystem::saveData() {
-    ofstream file(dataFile);
-    for (const auto& user : users) {
-        file << user->toFileString() << endl;
+    StoreLock::WriteGuard guard = storeLock.write();
+    writeData();
+}
+
+void BonusSystem::writeData() {
+    //         ;     .
+    string tempFile = dataFile + ".tmp";
+    ofstream file(tempFile, ios::trunc);
+    file << admin->toFileString() << '\n';
+    for (const auto& emp : employees) {
+        file << emp->toFileString() << '\n';
     }
+    file.flush();
+    bool written = file.good();
     file.close();
+
+    error_code ec;
+    if (written) filesystem::rename(tempFile, dataFile, ec);
+    if (!written || ec) {
+        filesystem::remove(tempFile, ec);
+        cout << "    .    ." << endl;
+        return;
+    }
+    Snapshot::write(snapshotFile, dataFile, [this](const Snapshot::EmployeeVisitor& visit) {
+        for (const auto& emp : employees) visit(*emp);
+    }, Snapshot::Image::Saved);
+    journal.clear();
     cout << "   ." << endl;
 }
 
-shared_ptr<User> BonusSystem::authenticate(const string& username, const string& password) {
-    for (const auto& user : users) {
-        if (user->getUsername() == username && user->verifyPassword(password) && user->getIsApproved()) {
-            return user;
-        }
+optional<UserRecord> BonusSystem::authenticate(const string& username, const string& password, string& fullName) {
+    StoreLock::ReadGuard guard = storeLock.read();
+    optional<UserRecord> user = usernameIndex.find(username);
+    if (user && recordUser(*user).verifyPassword(password) && recordUser(*user).getIsApproved()) {
+        fullName = recordUser(*user).getFullName();
+        return *user;
     }
-    return nullptr;
+    return nullopt;
 }
 
-bool BonusSystem::usernameExists(const string& username) {
-    for (const auto& user : users) {
-        if (user->getUsername() == username) return true;
-    }
-    return false;
+bool BonusSystem::usernameExists(string_view username) {
+    StoreLock::ReadGuard guard = storeLock.read();
+    return usernameIndex.contains(username);
 }
 
 void BonusSystem::registerUser() {
@@ -410,9 +1210,12 @@ void BonusSystem::registerUser() {
         if (isValidPosition(position)) break;
     }
 
-    auto emp = make_shared<Employee>(username, password, fullName, department, position, 0, Date());
+    auto emp = makePooled<Employee>(&employeePool, *strings, username, password, fullName, department, position, 0, Date());
     emp->setIsApproved(false);
-    pendingRegistrations.push_back(emp);
+    {
+        StoreLock::WriteGuard guard = storeLock.write();
+        pendingRegistrations.push_back(emp);
+    }
 
     cout << "\n   !" << endl;
     cout << "  ." << endl;
@@ -421,29 +1224,36 @@ void BonusSystem::registerUser() {
 void BonusSystem::approveRegistration() {
     cout << "\n--     --" << endl;
 
-    if (pendingRegistrations.empty()) {
-        cout << "   ." << endl;
-        return;
+    vector<shared_ptr<Employee>> listed;
+    {
+        StoreLock::ReadGuard guard = storeLock.read();
+        listed = pendingRegistrations;
+        for (size_t i = 0; i < listed.size(); i++) {
+            const auto& emp = listed[i];
+            cout << i + 1 << ". " << emp->getFullName() << " - " << emp->getDepartment() << ", " << emp->getPosition() << endl;
+        }
     }
 
-    for (size_t i = 0; i < pendingRegistrations.size(); i++) {
-        auto emp = dynamic_pointer_cast<Employee>(pendingRegistrations[i]);
-        cout << i + 1 << ". " << emp->getFullName() << " - " << emp->getDepartment() << ", " << emp->getPosition() << endl;
+    if (listed.empty()) {
+        cout << "   ." << endl;
+        return;
     }
 
     cout << "\n     (0  ): ";
-    int index = getIntInput("", 0, pendingRegistrations.size());
+    int index = getIntInput("", 0, listed.size());
 
     if (index == 0) {
         cout << " ." << endl;
         return;
     }
 
-    auto emp = dynamic_pointer_cast<Employee>(pendingRegistrations[index - 1]);
-    cout << "\n  : " << emp->getFullName() << endl;
+    auto emp = listed[index - 1];
+    {
+        StoreLock::ReadGuard guard = storeLock.read();
+        cout << "\n  : " << emp->getFullName() << endl;
+    }
 
     double salary = getDoubleInput(": ", 0, 1000000);
-    emp->setSalary(salary);
 
     int day, month, year;
     while (true) {
@@ -457,8 +1267,6 @@ void BonusSystem::approveRegistration() {
         }
     }
 
-    emp->setHireDate(Date(day, month, year));
-
     cout << "\n--   KPI   --" << endl;
     cout << "   0  100%:" << endl;
 
@@ -477,31 +1285,47 @@ void BonusSystem::approveRegistration() {
     }
 
     KPI newKPI(pc, cq, tw, in);
-    emp->setKPI(newKPI);
 
-    cout << "\n--    --" << endl;
-    cout << ": " << emp->getFullName() << endl;
-    cout << ": " << emp->getDepartment() << endl;
-    cout << ": " << emp->getPosition() << endl;
-    cout << ": " << salary << " BYN" << endl;
-    cout << " : " << day << "." << month << "." << year << endl;
-    cout << "KPI: " << newKPI.toString() << endl;
-    cout << " KPI: " << (int)newKPI.getTotalKPI() << "%" << endl;
+    {
+        StoreLock::ReadGuard guard = storeLock.read();
+        cout << "\n--    --" << endl;
+        cout << ": " << emp->getFullName() << endl;
+        cout << ": " << emp->getDepartment() << endl;
+        cout << ": " << emp->getPosition() << endl;
+        cout << ": " << salary << " BYN" << endl;
+        cout << " : " << day << "." << month << "." << year << endl;
+        cout << "KPI: " << newKPI.toString() << endl;
+        cout << " KPI: " << (int)newKPI.getTotalKPI() << "%" << endl;
+    }
 
     cout << "\n  ? (1 - , 0 - ): ";
     int confirm = getIntInput("", 0, 1);
 
-    if (confirm == 1) {
-        emp->setIsApproved(true);
-        employees.push_back(emp);
-        users.push_back(emp);
-        pendingRegistrations.erase(pendingRegistrations.begin() + index - 1);
+    if (confirm != 1) {
+        cout << "  ." << endl;
+        return;
+    }
 
-        saveData();
-        cout << "\n      !" << endl;
+    StoreLock::WriteGuard guard = storeLock.write();
+    auto pending = find(pendingRegistrations.begin(), pendingRegistrations.end(), emp);
+    if (pending == pendingRegistrations.end()) {
+        cout << "    ." << endl;
+    }
+    else if (usernameIndex.contains(emp->getUsername())) {
+        cout << "     !" << endl;
     }
     else {
-        cout << "  ." << endl;
+        emp->setSalary(salary);
+        emp->setHireDate(Date(day, month, year));
+        emp->setKPI(newKPI);
+        emp->setIsApproved(true);
+        attachEmployee(emp);
+        pendingRegistrations.erase(pending);
+
+        publishVersion();
+        journal.recordAdd(*emp);
+        compactJournalIfNeeded();
+        cout << "\n      !" << endl;
     }
 }
 
@@ -576,61 +1400,77 @@ void BonusSystem::addUser() {
         cout << ",    KPI." << endl;
     }
 
-    auto emp = make_shared<Employee>(username, password, fullName, department, position, salary, Date(day, month, year));
+    auto emp = makePooled<Employee>(&employeePool, *strings, username, password, fullName, department, position, salary, Date(day, month, year));
     emp->setKPI(KPI(pc, cq, tw, in));
-    employees.push_back(emp);
-    users.push_back(emp);
 
-    saveData();
+    StoreLock::WriteGuard guard = storeLock.write();
+    if (usernameIndex.contains(username)) {
+        cout << "     !" << endl;
+        return;
+    }
+    attachEmployee(emp);
+    publishVersion();
+
+    journal.recordAdd(*emp);
+    compactJournalIfNeeded();
     cout << "  !" << endl;
 }
 
 void BonusSystem::deleteUser() {
-    if (employees.empty()) {
+    vector<Handle> listed = displayAllEmployees();
+    if (listed.empty()) {
         cout << "   ." << endl;
         return;
     }
 
-    displayAllEmployees();
     cout << "\n     (0  ): ";
-    int index = getIntInput("", 0, employees.size());
+    int index = getIntInput("", 0, listed.size());
 
     if (index == 0) {
         cout << " ." << endl;
         return;
     }
 
-    auto emp = employees[index - 1];
-    auto it = find(employees.begin(), employees.end(), emp);
-    if (it != employees.end()) employees.erase(it);
-
-    auto it2 = find(users.begin(), users.end(), emp);
-    if (it2 != users.end()) users.erase(it2);
+    StoreLock::WriteGuard guard = storeLock.write();
+    if (!employees.contains(listed[index - 1])) {
+        cout << "    ." << endl;
+        return;
+    }
 
-    saveData();
+    size_t row = employees.indexOf(listed[index - 1]);
+    journal.recordDelete(employees[row]->getUsername());
+    detachEmployee(row);
+    publishVersion();
+    compactJournalIfNeeded();
     cout << "  !" << endl;
 }
 
 void BonusSystem::viewEmployeeDetails() {
-    if (employees.empty()) {
+    vector<Handle> listed = displayAllEmployees();
+    if (listed.empty()) {
         cout << "   ." << endl;
         return;
     }
 
-    displayAllEmployees();
     cout << "\n       (0  ): ";
-    int index = getIntInput("", 0, employees.size());
+    int index = getIntInput("", 0, listed.size());
 
     if (index == 0) {
         cout << " ." << endl;
         return;
     }
 
-    employees[index - 1]->displayDetailedInfo(formula);
+    StoreLock::ReadGuard guard = storeLock.read();
+    const shared_ptr<Employee>* emp = employees.get(listed[index - 1]);
+    if (!emp) {
+        cout << "   ." << endl;
+        return;
+    }
+    (*emp)->displayDetailedInfo(formula, currentAsOf());
 }
 
 void BonusSystem::searchUsers() {
-    if (employees.empty()) {
+    if (!hasEmployees()) {
         cout << "   ." << endl;
         return;
     }
@@ -655,27 +1495,34 @@ void BonusSystem::searchUsers() {
     getline(cin, searchTerm);
 
     string searchTermLower = toLowerRussian(searchTerm);
+    StoreLock::ReadGuard guard = choice == 1 ? readDerived(Derived::NameIndex) : storeLock.read();
+    AsOfDate asOf = currentAsOf();
     vector<shared_ptr<Employee>> results;
+    if (choice == 1) {
+        vector<uint32_t> candidates;
+        if (nameIndex.candidates(searchTermLower, candidates)) {
+            for (uint32_t row : candidates) {
+                if (nameKey(row).find(searchTermLower) != string::npos) results.push_back(employees[row]);
+            }
+        }
+        else {
+            for (size_t row = 0; row < versions.size(); row++) {
+                if (nameKey(row).find(searchTermLower) != string::npos) results.push_back(employees[row]);
+            }
+        }
+    }
+    else {
+        const StringDictionary& dictionary = choice == 2 ?
+            StringDictionary::positions() : StringDictionary::departments();
 
-    for (const auto& emp : employees) {
-        bool match = false;
-        string compareString;
-
-        switch (choice) {
-        case 1:
-            compareString = toLowerRussian(emp->getFullName());
-            match = (compareString.find(searchTermLower) != string::npos);
-            break;
-        case 2:
-            compareString = toLowerRussian(emp->getPosition());
-            match = (compareString.find(searchTermLower) != string::npos);
-            break;
-        case 3:
-            compareString = toLowerRussian(emp->getDepartment());
-            match = (compareString.find(searchTermLower) != string::npos);
-            break;
+        vector<char> matches(dictionary.size());
+        for (uint32_t id = 0; id < matches.size(); id++) {
+            matches[id] = toLowerRussian(dictionary.name(id)).find(searchTermLower) != string::npos;
+        }
+        for (size_t row = 0; row < versions.size(); row++) {
+            const VersionRow& entry = versions.row(row);
+            if (matches[choice == 2 ? entry.positionId : entry.departmentId]) results.push_back(employees[row]);
         }
-        if (match) results.push_back(emp);
     }
 
     if (results.empty()) {
@@ -686,13 +1533,13 @@ void BonusSystem::searchUsers() {
         for (size_t i = 0; i < results.size(); i++) {
             cout << i + 1 << ". " << results[i]->getFullName() << " - "
                 << results[i]->getPosition() << " (" << results[i]->getDepartment()
-                << ") : " << results[i]->calculateBonus(formula) << " BYN" << endl;
+                << ") : " << results[i]->calculateBonus(formula, asOf) << " BYN" << endl;
         }
     }
 }
 
 void BonusSystem::sortUsers() {
-    if (employees.empty()) {
+    if (!hasEmployees()) {
         cout << "   ." << endl;
         return;
     }
@@ -702,92 +1549,124 @@ void BonusSystem::sortUsers() {
     cout << "2.   " << endl;
     cout << "3.  " << endl;
     cout << "4.  " << endl;
+    cout << "5.   " << endl;
     cout << "0. " << endl;
     cout << "  : ";
 
-    int choice = getIntInput("", 0, 4);
+    int choice = getIntInput("", 0, 5);
 
     if (choice == 0) {
         cout << " ." << endl;
         return;
     }
 
-    vector<shared_ptr<Employee>> sortedEmployees = employees;
+    shared_ptr<const StoreVersion> version = pinVersion();
+    shared_ptr<const VersionColumns> derived = version->columns();
+    const StoreVersion& rows = *version;
+    vector<size_t> order(rows.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
 
     switch (choice) {
-    case 1:
-        sort(sortedEmployees.begin(), sortedEmployees.end(),
-            [](const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
-                return toLowerRussian(a->getFullName()) < toLowerRussian(b->getFullName());
-            });
+    case 1: {
+        //       .
+        vector<string> keys(rows.size());
+        for (size_t i = 0; i < keys.size(); i++) keys[i] = toLowerRussian(rows[i].fullName());
+        sortRows(order, [&keys](size_t a, size_t b) {
+            return keys[a] < keys[b];
+        });
         break;
+    }
     case 2:
-        sort(sortedEmployees.begin(), sortedEmployees.end(),
-            [this](const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
-                return a->calculateBonus(formula) > b->calculateBonus(formula);
-            });
+        sortRows(order, [&derived](size_t a, size_t b) {
+            return derived->bonus[a] > derived->bonus[b];
+        });
         break;
     case 3:
-        sort(sortedEmployees.begin(), sortedEmployees.end(),
-            [](const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
-                return a->getExperience() > b->getExperience();
-            });
+        sortRows(order, [&derived](size_t a, size_t b) {
+            return derived->experience[a] > derived->experience[b];
+        });
         break;
-    case 4:
-        sort(sortedEmployees.begin(), sortedEmployees.end(),
-            [](const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
-                return toLowerRussian(a->getDepartment()) < toLowerRussian(b->getDepartment());
-            });
+    case 4: {
+        const StringDictionary& dictionary = StringDictionary::departments();
+        vector<string> keys(dictionary.size());
+        vector<uint32_t> ids(keys.size());
+        for (uint32_t id = 0; id < keys.size(); id++) {
+            keys[id] = toLowerRussian(dictionary.name(id));
+            ids[id] = id;
+        }
+        sort(ids.begin(), ids.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+        vector<uint32_t> rank(ids.size());
+        for (uint32_t i = 0; i < ids.size(); i++) rank[ids[i]] = i;
+        sortRows(order, [&rows, &rank](size_t a, size_t b) {
+            return rank[rows[a].departmentId] < rank[rows[b].departmentId];
+        });
+        break;
+    }
+    case 5:
+        sortRows(order, [&rows](size_t a, size_t b) {
+            return rows[a].hireDay < rows[b].hireDay;
+        });
         break;
     }
 
+    const StringDictionary& departmentNames = StringDictionary::departments();
+    const StringDictionary& positionNames = StringDictionary::positions();
     cout << "\n :" << endl;
-    for (size_t i = 0; i < sortedEmployees.size(); i++) {
-        auto emp = sortedEmployees[i];
-        cout << i + 1 << ". " << emp->getFullName() << " - " << emp->getDepartment()
-            << ", " << emp->getPosition() << " (: " << emp->calculateBonus(formula)
-            << " BYN, : " << emp->getExperience() << " )" << endl;
+    for (size_t i = 0; i < order.size(); i++) {
+        size_t row = order[i];
+        cout << i + 1 << ". " << rows[row].fullName() << " - " << departmentNames.name(rows[row].departmentId)
+            << ", " << positionNames.name(rows[row].positionId) << " (: " << derived->bonus[row]
+            << " BYN, : " << derived->experience[row] << " )" << endl;
     }
 }
 
 void BonusSystem::viewAllUsers() {
-    if (employees.empty()) {
+    shared_ptr<const StoreVersion> version = pinVersion();
+    if (version->empty()) {
         cout << "   ." << endl;
         return;
     }
 
+    printEmployeeTable(*version);
+}
+
+void BonusSystem::printEmployeeTable(const StoreVersion& version) {
+    shared_ptr<const VersionColumns> derived = version.columns();
+    const StringDictionary& positions = StringDictionary::positions();
+
     cout << "\n  :" << endl;
     drawTableLine();
     drawTableHeader();
     drawTableLine();
 
-    for (size_t i = 0; i < employees.size(); i++) {
-        auto emp = employees[i];
-        double bonus = emp->calculateBonus(formula);
-        double kpi = emp->getKPI().getTotalKPI();
+    for (size_t i = 0; i < version.size(); i++) {
+        const VersionRow& row = version[i];
+        double bonus = derived->bonus[i];
+        double kpi = derived->totalKPI[i];
 
-        vector<string> nameLines = splitText(emp->getFullName(), 19);
+        vector<string> nameLines = splitText(row.fullName(), 19);
 
         for (size_t j = 0; j < nameLines.size(); j++) {
             if (j == 0) {
-                cout << "| " << centerText(to_string(i + 1), 3) << " | "
-                    << centerText(emp->getUsername(), 19) << " | "
-                    << centerText(nameLines[j], 19) << " | "
-                    << centerText(emp->getPosition(), 20) << " | "
-                    << centerText(to_string((int)kpi), 5) << " | "
+                cout << "| " << centered(to_string(i + 1), 3) << " | "
+                    << centered(row.username(), 19) << " | "
+                    << centered(nameLines[j], 19) << " | "
+                    << centered(positions.name(row.positionId), 20) << " | "
+                    << centered(to_string((int)kpi), 5) << " | "
                     << formatDouble(bonus, 14) << " |" << endl;
             }
             else {
-                cout << "| " << centerText("", 3) << " | "
-                    << centerText("", 19) << " | "
-                    << centerText(nameLines[j], 19) << " | "
-                    << centerText("", 20) << " | "
-                    << centerText("", 5) << " | "
-                    << centerText("", 14) << " |" << endl;
+                cout << "| " << centered("", 3) << " | "
+                    << centered("", 19) << " | "
+                    << centered(nameLines[j], 19) << " | "
+                    << centered("", 20) << " | "
+                    << centered("", 5) << " | "
+                    << centered("", 14) << " |" << endl;
             }
         }
 
-        if (nameLines.size() > 1 && i < employees.size() - 1) {
+        if (nameLines.size() > 1 && i < version.size() - 1) {
             drawTableLine();
         }
     }
@@ -795,25 +1674,47 @@ void BonusSystem::viewAllUsers() {
 }
 
 void BonusSystem::editEmployeeData() {
-    if (employees.empty()) {
+    vector<Handle> listed = displayAllEmployees();
+    if (listed.empty()) {
         cout << "   ." << endl;
         return;
     }
 
-    displayAllEmployees();
     cout << "\n     (0  ): ";
-    int index = getIntInput("", 0, employees.size());
+    int index = getIntInput("", 0, listed.size());
 
     if (index == 0) {
         cout << " ." << endl;
         return;
     }
 
-    auto emp = employees[index - 1];
+    Handle handle = listed[index - 1];
+    shared_ptr<Employee> emp;
+    {
+        StoreLock::ReadGuard guard = storeLock.read();
+        if (employees.contains(handle)) emp = *employees.get(handle);
+    }
+
+    auto removed = [this, handle]() {
+        if (employees.contains(handle)) return false;
+        cout << "   ." << endl;
+        return true;
+    };
+
+    //     ,  ,     .
+    auto compactJournal = [this]() {
+        if (!journal.needsCompaction()) return;
+        StoreLock::WriteGuard guard = storeLock.write();
+        compactJournalIfNeeded();
+    };
 
     int choice;
     do {
-        cout << "\n--  : " << emp->getFullName() << " --" << endl;
+        {
+            StoreLock::ReadGuard guard = storeLock.read();
+            if (removed()) return;
+            cout << "\n--  : " << emp->getFullName() << " --" << endl;
+        }
         cout << "1.   " << endl;
         cout << "2.   KPI" << endl;
         cout << "3.  " << endl;
@@ -832,14 +1733,23 @@ void BonusSystem::editEmployeeData() {
                 getline(cin >> ws, newName);
                 if (isValidName(newName)) break;
             }
-            emp->setFullName(newName);
-            saveData();
+            {
+                StoreLock::EditGuard guard = lockEmployee(handle);
+                if (removed()) return;
+                emp->setFullName(newName);
+                commitRow(handle);
+                journal.recordName(emp->getUsername(), newName);
+            }
+            compactJournal();
             cout << "  !" << endl;
             break;
         }
         case 2: {
             double pc, cq, tw, in;
-            cout << " KPI: " << emp->getKPI().toString() << endl;
+            {
+                StoreLock::ReadGuard guard = storeLock.read();
+                cout << " KPI: " << emp->getKPI().toString() << endl;
+            }
 
             while (true) {
                 pc = getDoubleInput("  (%): ", 0, 100);
@@ -853,21 +1763,36 @@ void BonusSystem::editEmployeeData() {
             }
 
             KPI newKPI(pc, cq, tw, in);
-            emp->setKPI(newKPI);
-            saveData();
+            {
+                StoreLock::EditGuard guard = lockEmployee(handle);
+                if (removed()) return;
+                emp->setKPI(newKPI);
+                commitRow(handle);
+                journal.recordKPI(emp->getUsername(), newKPI);
+            }
+            compactJournal();
             cout << "KPI  !" << endl;
             break;
         }
         case 3: {
             double newSalary = getDoubleInput(" : ", 0, 1000000);
-            emp->setSalary(newSalary);
-            saveData();
+            {
+                StoreLock::EditGuard guard = lockEmployee(handle);
+                if (removed()) return;
+                emp->setSalary(newSalary);
+                commitRow(handle);
+                journal.recordSalary(emp->getUsername(), newSalary);
+            }
+            compactJournal();
             cout << "  !" << endl;
             break;
         }
         case 4: {
             int day, month, year;
-            cout << "  : " << emp->getHireDate().toString() << endl;
+            {
+                StoreLock::ReadGuard guard = storeLock.read();
+                cout << "  : " << emp->getHireDate().toString() << endl;
+            }
 
             while (true) {
                 cout << "  :" << endl;
@@ -880,8 +1805,14 @@ void BonusSystem::editEmployeeData() {
                 }
             }
 
-            emp->setHireDate(Date(day, month, year));
-            saveData();
+            {
+                StoreLock::EditGuard guard = lockEmployee(handle);
+                if (removed()) return;
+                emp->setHireDate(Date(day, month, year));
+                commitRow(handle);
+                journal.recordHireDate(emp->getUsername(), emp->getHireDate());
+            }
+            compactJournal();
             cout << "   !" << endl;
             break;
         }
@@ -897,9 +1828,15 @@ void BonusSystem::editEmployeeData() {
                 getline(cin >> ws, newPos);
                 if (isValidPosition(newPos)) break;
             }
-            emp->setDepartment(newDept);
-            emp->setPosition(newPos);
-            saveData();
+            {
+                StoreLock::EditGuard guard = lockEmployee(handle, StringDictionary::departments().intern(newDept));
+                if (removed()) return;
+                emp->setDepartment(newDept);
+                emp->setPosition(newPos);
+                commitRow(handle);
+                journal.recordPosition(emp->getUsername(), newDept, newPos);
+            }
+            compactJournal();
             cout << "    !" << endl;
             break;
         }
@@ -911,69 +1848,72 @@ void BonusSystem::editEmployeeData() {
 }
 
 void BonusSystem::calculateAndViewBonuses() {
-    if (employees.empty()) {
+    shared_ptr<const StoreVersion> version = pinVersion();
+    if (version->empty()) {
         cout << "    ." << endl;
         return;
     }
 
     cout << "\n--     --" << endl;
 
-    formula.displayFormula();
-
-    double totalBonus = 0;
-    double maxBonus = 0;
-    double minBonus = numeric_limits<double>::max();
-    string bestEmployee, worstEmployee;
+    version->getFormula().displayFormula();
+    shared_ptr<const VersionColumns> derived = version->columns();
 
     cout << "\n  :" << endl;
     cout << "-------------------------------------------------------------" << endl;
     cout << "|                      |  | KPI  |  |   |" << endl;
     cout << "-------------------------------------------------------------" << endl;
 
-    for (const auto& emp : employees) {
-        double bonus = emp->calculateBonus(formula);
-        double kpi = emp->getKPI().getTotalKPI();
-        int experience = emp->getExperience();
-
-        totalBonus += bonus;
+    for (size_t i = 0; i < version->size(); i++) {
+        double bonus = derived->bonus[i];
+        double kpi = derived->totalKPI[i];
+        int experience = derived->experience[i];
 
-        if (bonus > maxBonus) {
-            maxBonus = bonus;
-            bestEmployee = emp->getFullName();
-        }
-        if (bonus < minBonus) {
-            minBonus = bonus;
-            worstEmployee = emp->getFullName();
+        string_view name = (*version)[i].fullName();
+        string shortened;
+        if (name.length() > 22) {
+            shortened.assign(name.substr(0, 19)).append("...");
+            name = shortened;
         }
 
-        string name = emp->getFullName();
-        if (name.length() > 22) name = name.substr(0, 19) + "...";
-
         cout << "| " << left << setw(23) << name
-            << "| " << setw(9) << emp->getSalary()
+            << "| " << setw(9) << derived->salary[i]
             << "| " << setw(4) << (int)kpi << "%"
             << "| " << setw(4) << experience
             << "| " << setw(5) << (int)bonus << " BYN |" << endl;
     }
     cout << "-------------------------------------------------------------" << endl;
 
+    const PayrollSummary& summary = version->getSummary();
+    const GroupSummary& total = summary.company;
     cout << "\n :" << endl;
-    cout << "  : " << totalBonus << " BYN" << endl;
-    cout << " : " << totalBonus / employees.size() << " BYN" << endl;
-    cout << " : " << maxBonus << " BYN (" << bestEmployee << ")" << endl;
-    cout << " : " << minBonus << " BYN (" << worstEmployee << ")" << endl;
+    cout << "  : " << total.bonusSum << " BYN" << endl;
+    cout << " : " << total.bonusSum / total.count << " BYN" << endl;
+    cout << " : " << total.maxBonus << " BYN (" << total.bestName << ")" << endl;
+    cout << " : " << total.minBonus << " BYN (" << total.worstName << ")" << endl;
+
+    cout << "\n  :" << endl;
+    for (uint32_t id = 0; id < summary.departments.size(); id++) {
+        const GroupSummary& group = summary.departments[id];
+        if (group.count == 0) continue;
+        cout << " " << StringDictionary::departments().name(id) << ":  " << group.count
+            << ",   " << group.salarySum << " BYN,  " << group.bonusSum
+            << " BYN (. " << group.minBonus << ", . " << group.maxBonus << ")" << endl;
+    }
 
     cout << "\n:" << endl;
-    bool hasRecommendations = false;
-    for (const auto& emp : employees) {
-        double kpi = emp->getKPI().getTotalKPI();
-        if (kpi < 70) {
-            cout << " " << emp->getFullName() << ":  KPI (" << (int)kpi << "%).   ." << endl;
-            hasRecommendations = true;
-        }
-    }
-    if (!hasRecommendations) {
+    if (total.lowKpiCount == 0) {
         cout << "     KPI!" << endl;
+        return;
+    }
+    //   ,   ;      .
+    size_t remaining = total.lowKpiCount;
+    for (size_t i = 0; i < version->size() && remaining > 0; i++) {
+        double kpi = derived->totalKPI[i];
+        if (kpi < PayrollAggregates::LOW_KPI_THRESHOLD) {
+            cout << " " << (*version)[i].fullName() << ":  KPI (" << (int)kpi << "%).   ." << endl;
+            remaining--;
+        }
     }
 }
 
@@ -982,7 +1922,12 @@ void BonusSystem::configureBonusFormula() {
     do {
         cout << "\n--     --" << endl;
         cout << " :" << endl;
-        formula.displayFormula();
+        BonusFormula current;
+        {
+            StoreLock::ReadGuard guard = storeLock.read();
+            current = formula;
+        }
+        current.displayFormula();
 
         cout << "\n :" << endl;
         cout << "1.   KPI" << endl;
@@ -990,48 +1935,69 @@ void BonusSystem::configureBonusFormula() {
         cout << "3.     " << endl;
         cout << "4.     " << endl;
         cout << "5.     " << endl;
+        cout << "6.     " << endl;
         cout << "0. " << endl;
         cout << " : ";
 
-        choice = getIntInput("", 0, 5);
+        choice = getIntInput("", 0, 6);
 
         switch (choice) {
         case 1: {
             cout << "\n--   KPI --" << endl;
-            cout << " : " << formula.getKpiCoefficient() << " (" << formula.getKpiCoefficient() * 100 << "%)" << endl;
+            cout << " : " << current.getKpiCoefficient() << " (" << current.getKpiCoefficient() * 100 << "%)" << endl;
 
             double newCoeff = getDoubleInput("\n   (0.0 - 1.0): ", 0.0, 1.0);
-            formula.setKpiCoefficient(newCoeff);
-            saveFormula();
+            {
+                StoreLock::WriteGuard guard = storeLock.write();
+                formula.setKpiCoefficient(newCoeff);
+                writeFormula();
+                publishVersion();
+            }
             cout << " KPI  !" << endl;
+            showPayrollForecast();
             break;
         }
         case 2: {
             cout << "\n--    --" << endl;
-            cout << " : " << formula.getExperienceCoefficient() << " (" << formula.getExperienceCoefficient() * 100 << "%  )" << endl;
+            cout << " : " << current.getExperienceCoefficient() << " (" << current.getExperienceCoefficient() * 100 << "%  )" << endl;
 
             double newCoeff = getDoubleInput("\n   (0.0 - 0.1): ", 0.0, 0.1);
-            formula.setExperienceCoefficient(newCoeff);
-            saveFormula();
+            {
+                StoreLock::WriteGuard guard = storeLock.write();
+                formula.setExperienceCoefficient(newCoeff);
+                writeFormula();
+                publishVersion();
+            }
             cout << "   !" << endl;
+            showPayrollForecast();
             break;
         }
         case 3: {
             cout << "\n--      --" << endl;
-            cout << " : " << formula.getMaxExperienceBonus() << " (" << formula.getMaxExperienceBonus() * 100 << "%)" << endl;
+            cout << " : " << current.getMaxExperienceBonus() << " (" << current.getMaxExperienceBonus() * 100 << "%)" << endl;
 
             double newMax = getDoubleInput("\n    (0.0 - 0.5): ", 0.0, 0.5);
-            formula.setMaxExperienceBonus(newMax);
-            saveFormula();
+            {
+                StoreLock::WriteGuard guard = storeLock.write();
+                formula.setMaxExperienceBonus(newMax);
+                writeFormula();
+                publishVersion();
+            }
             cout << "     !" << endl;
+            showPayrollForecast();
             break;
         }
         case 4: {
             cout << "\n--      --" << endl;
-            formula = BonusFormula();
-            saveFormula();
-            cout << "     :" << endl;
-            formula.displayFormula();
+            {
+                StoreLock::WriteGuard guard = storeLock.write();
+                formula = BonusFormula();
+                writeFormula();
+                publishVersion();
+                cout << "     :" << endl;
+                formula.displayFormula();
+            }
+            showPayrollForecast();
             break;
         }
         case 5: {
@@ -1041,21 +2007,24 @@ void BonusSystem::configureBonusFormula() {
             double kpi = getDoubleInput("KPI  (%): ", 0, 100);
             int experience = getIntInput("  (): ", 0, 50);
 
-            double bonus = formula.calculateBonus(salary, kpi, experience);
-            double kpiBonus = (kpi / 100) * formula.getKpiCoefficient() * salary;
-            double expBonus = min(experience * formula.getExperienceCoefficient(), formula.getMaxExperienceBonus()) * salary;
+            double bonus = current.calculateBonus(salary, kpi, experience);
+            double kpiBonus = (kpi / 100) * current.getKpiCoefficient() * salary;
+            double expBonus = min(experience * current.getExperienceCoefficient(), current.getMaxExperienceBonus()) * salary;
 
             cout << "\n :" << endl;
             cout << ": " << salary << " BYN" << endl;
             cout << "KPI: " << kpi << "%" << endl;
             cout << ": " << experience << " " << endl;
             cout << "----------------------------------------" << endl;
-            cout << "  KPI: " << kpiBonus << " BYN (" << (kpi / 100) * formula.getKpiCoefficient() * 100 << "%)" << endl;
-            cout << "  : " << expBonus << " BYN (" << min(experience * formula.getExperienceCoefficient(), formula.getMaxExperienceBonus()) * 100 << "%)" << endl;
+            cout << "  KPI: " << kpiBonus << " BYN (" << (kpi / 100) * current.getKpiCoefficient() * 100 << "%)" << endl;
+            cout << "  : " << expBonus << " BYN (" << min(experience * current.getExperienceCoefficient(), current.getMaxExperienceBonus()) * 100 << "%)" << endl;
             cout << "----------------------------------------" << endl;
             cout << " : " << bonus << " BYN (" << (bonus / salary) * 100 << "%  )" << endl;
             break;
         }
+        case 6:
+            sweepBonusFormula();
+            break;
         case 0:
             cout << "  ..." << endl;
             break;
@@ -1063,6 +2032,136 @@ void BonusSystem::configureBonusFormula() {
     } while (choice != 0);
 }
 
+void BonusSystem::sweepBonusFormula() {
+    cout << "\n--   --" << endl;
+    if (!hasEmployees()) {
+        cout << "   ." << endl;
+        return;
+    }
+
+    cout << " KPI:" << endl;
+    SweepRange kpi;
+    kpi.from = getDoubleInput("   (0.0 - 1.0): ", 0.0, 1.0);
+    kpi.to = getDoubleInput("   (0.0 - 1.0): ", kpi.from, 1.0);
+    kpi.step = getDoubleInput("   (0.0 - 1.0): ", 0.0, 1.0);
+
+    cout << " :" << endl;
+    SweepRange exp;
+    exp.from = getDoubleInput("   (0.0 - 0.1): ", 0.0, 0.1);
+    exp.to = getDoubleInput("   (0.0 - 0.1): ", exp.from, 0.1);
+    exp.step = getDoubleInput("   (0.0 - 0.1): ", 0.0, 0.1);
+
+    cout << "   :" << endl;
+    SweepRange maxExp;
+    maxExp.from = getDoubleInput("   (0.0 - 0.5): ", 0.0, 0.5);
+    maxExp.to = getDoubleInput("   (0.0 - 0.5): ", maxExp.from, 0.5);
+    maxExp.step = getDoubleInput("   (0.0 - 0.5): ", 0.0, 0.5);
+
+    size_t pointCount = kpi.count() * exp.count() * maxExp.count();
+    if (pointCount > FormulaSweep::MAX_POINTS) {
+        cout << "   (" << pointCount << "),  " << FormulaSweep::MAX_POINTS << "." << endl;
+        return;
+    }
+
+    //        ,       .
+    shared_ptr<const StoreVersion> version = pinVersion();
+    shared_ptr<const VersionColumns> derived = version->columns();
+    vector<uint32_t> departmentIds(version->size());
+    uint32_t departmentCount = 0;
+    for (size_t row = 0; row < version->size(); row++) {
+        departmentIds[row] = (*version)[row].departmentId;
+        departmentCount = max(departmentCount, departmentIds[row] + 1);
+    }
+
+    FormulaSweep sweep(derived->salary, derived->totalKPI, derived->experience, departmentIds, departmentCount);
+    vector<SweepPoint> points = sweep.run(kpi, exp, maxExp);
+    vector<string> names;
+    for (uint32_t id = 0; id < departmentCount; id++) {
+        names.push_back(StringDictionary::departments().name(id));
+    }
+
+    cout << "\n| KPI    |    | .  |    |     |" << endl;
+    cout << "|--------|--------|--------|--------------|------------|" << endl;
+    for (const auto& point : points) {
+        cout << "| " << left << setw(7) << point.kpiCoefficient
+            << "| " << setw(7) << point.experienceCoefficient
+            << "| " << setw(7) << point.maxExperienceBonus
+            << "| " << setw(13) << point.total
+            << "| " << setw(11) << point.median << "|" << endl;
+    }
+
+    cout << "\n   CSV? (1 - , 0 - ): ";
+    if (getIntInput("", 0, 1) == 1) {
+        string filename = "formula_sweep.csv";
+        if (FormulaSweep::writeCsv(filename, points, names)) {
+            cout << "    " << filename << " (   )." << endl;
+        }
+        else {
+            cout << "    " << filename << "." << endl;
+        }
+    }
+}
+
+void BonusSystem::reportMemoryUsage() const {
+    StoreLock::ReadGuard guard = storeLock.read();
+    size_t count = employees.size();
+    if (count == 0) {
+        cout << "    ." << endl;
+        return;
+    }
+
+    //  ,     :    ,    ,
+    //  ,  ,      .
+    auto perRow = [count](size_t bytes) { return (double)bytes / count; };
+    size_t poolBytes = employeePool.reservedBytes();
+    size_t arenaBytes = strings->reservedBytes();
+    size_t repositoryBytes = employees.memoryBytes();
+    size_t loginBytes = usernameIndex.memoryBytes();
+    size_t versionBytes = versions.memoryBytes();
+    size_t departmentBytes = departments.memoryBytes();
+    size_t trigramBytes = nameIndexValid ? nameIndex.memoryBytes() : 0;
+    size_t aggregateBytes = aggregates.memoryBytes() + payrollModel.memoryBytes();
+    size_t total = poolBytes + arenaBytes + repositoryBytes + loginBytes + versionBytes + departmentBytes +
+        trigramBytes + aggregateBytes;
+
+    cout << fixed << setprecision(1);
+    cout << "   ():" << endl;
+    cout << "    Employee (" << sizeof(Employee) << " )     : " << perRow(poolBytes) << endl;
+    cout << "     : " << perRow(arenaBytes) << endl;
+    cout << "    : " << perRow(repositoryBytes) << endl;
+    cout << "    : " << perRow(loginBytes) << endl;
+    cout << "     (" << sizeof(VersionRow) << " )  : " << perRow(versionBytes) << endl;
+    cout << "    : " << perRow(departmentBytes) << endl;
+    if (nameIndexValid) {
+        cout << "     : " << perRow(trigramBytes) << endl;
+    }
+    else {
+        cout << "     :   (   )" << endl;
+    }
+    cout << "       ( ,   ): " << perRow(aggregateBytes) << endl;
+    cout << "   : " << perRow(total) << endl;
+    cout << defaultfloat << setprecision(6);
+    cout << " :  " << employeePool.allocationCount() << ",  "
+        << employeePool.releaseCount() << ",   " << employeePool.chunkCount()
+        << " (" << poolBytes << " )" << endl;
+    cout << " :  " << strings->storedBytes() << "  " << arenaBytes << " " << endl;
+#ifdef RECORD_POOL_DIAGNOSTICS
+    cout << "   : " << AllocationCounter::count() << endl;
+#endif
+}
+
+void BonusSystem::reportLockUsage() const {
+    auto print = [](const char* title, const LockStats& stats) {
+        cout << "   " << title << ":  " << stats.acquisitions << ",  " << stats.averageWaitMicros()
+            << " ,  " << stats.averageHoldMicros() << "  (. " << stats.maxHoldNanos / 1000 << " )" << endl;
+    };
+
+    cout << " :" << endl;
+    print("", storeLock.readStats());
+    print("", storeLock.writeStats());
+    print(" ", storeLock.editStats());
+}
+
 string BonusSystem::getHiddenPassword() {
     string password;
     char ch;
@@ -1082,9 +2181,25 @@ string BonusSystem::getHiddenPassword() {
     return password;
 }
 
-void BonusSystem::displayAllEmployees() {
-    viewAllUsers();
+vector<Handle> BonusSystem::displayAllEmployees() {
+    shared_ptr<const StoreVersion> version = pinVersion();
+    vector<Handle> listed(version->size());
+    for (size_t i = 0; i < listed.size(); i++) {
+        listed[i] = (*version)[i].handle;
+    }
+    if (!listed.empty()) printEmployeeTable(*version);
+    return listed;
 }
 
-vector<shared_ptr<Employee>>& BonusSystem::getEmployees() { return employees; }
-vector<shared_ptr<User>>& BonusSystem::getPendingRegistrations() { return pendingRegistrations; }
\ No newline at end of file
+DepartmentView BonusSystem::operator()(const string& dept) {
+    int id = StringDictionary::departments().find(dept);
+    return DepartmentView(pinVersion(), id < 0 ? UINT32_MAX : (uint32_t)id);
+}
+
+shared_ptr<const StoreVersion> BonusSystem::getEmployees() { return pinVersion(); }
+const StoreLock& BonusSystem::getStoreLock() const { return storeLock; }
+
+vector<shared_ptr<Employee>> BonusSystem::getPendingRegistrations() const {
+    StoreLock::ReadGuard guard = storeLock.read();
+    return pendingRegistrations;
+}
\ No newline at end of file
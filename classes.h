@@ -2,48 +2,262 @@
 #define CLASSES_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <variant>
+#include <optional>
 #include <ctime>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
 #include <iostream>
 #include <sstream>
+#include "journal.h"
+#include "data_loader.h"
+#include "search_index.h"
+#include "payroll_stats.h"
+#include "dictionary.h"
+#include "string_arena.h"
+#include "record_pool.h"
+#include "store_lock.h"
 using namespace std;
 
 namespace Encryption {
-    string hashPassword(const string& password);
-    bool verifyPassword(const string& password, const string& hashedPassword);
+    string hashPassword(string_view password);
+    bool verifyPassword(string_view password, string_view hashedPassword);
 }
 
+// ,    :      .
+struct PasswordHash {
+    string_view value;
+};
+
+struct Handle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const Handle& other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
 template<typename T>
 class Repository {
 private:
+    struct Slot {
+        uint32_t position;
+        uint32_t generation;
+    };
+
     vector<T> items;
+    vector<uint32_t> owners;
+    vector<Slot> slots;
+    uint32_t freeHead = UINT32_MAX;
+
 public:
-    void add(const T& item) { items.push_back(item); }
-    void remove(const T& item) {
-        auto it = find(items.begin(), items.end(), item);
-        if (it != items.end()) items.erase(it);
+    Handle add(T item) {
+        uint32_t slot;
+        if (freeHead != UINT32_MAX) {
+            slot = freeHead;
+            freeHead = slots[slot].position;
+        }
+        else {
+            slot = (uint32_t)slots.size();
+            slots.push_back({ 0, 0 });
+        }
+
+        slots[slot].position = (uint32_t)items.size();
+        items.push_back(move(item));
+        owners.push_back(slot);
+        return { slot, slots[slot].generation };
     }
-    vector<T> getAll() const { return items; }
+
+    bool remove(Handle handle) {
+        if (!contains(handle)) return false;
+
+        uint32_t position = slots[handle.slot].position;
+        uint32_t last = (uint32_t)items.size() - 1;
+        if (position != last) {
+            items[position] = move(items[last]);
+            owners[position] = owners[last];
+            slots[owners[position]].position = position;
+        }
+        items.pop_back();
+        owners.pop_back();
+
+        slots[handle.slot].generation++;
+        slots[handle.slot].position = freeHead;
+        freeHead = handle.slot;
+        return true;
+    }
+
+    bool contains(Handle handle) const {
+        return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation;
+    }
+
+    T* get(Handle handle) { return contains(handle) ? &items[slots[handle.slot].position] : nullptr; }
+    const T* get(Handle handle) const { return contains(handle) ? &items[slots[handle.slot].position] : nullptr; }
+    size_t indexOf(Handle handle) const { return slots[handle.slot].position; }
+    Handle handleAt(size_t index) const { return { owners[index], slots[owners[index]].generation }; }
+    //           ,    .
+    const T& atSlot(uint32_t slot) const { return items[slots[slot].position]; }
+
+    void reserve(size_t count) {
+        items.reserve(count);
+        owners.reserve(count);
+        slots.reserve(count);
+    }
+    size_t memoryBytes() const {
+        return items.capacity() * sizeof(T) + owners.capacity() * sizeof(uint32_t) + slots.capacity() * sizeof(Slot);
+    }
+
+    void clear() {
+        for (size_t i = items.size(); i-- > 0;) remove(handleAt(i));
+    }
+
+    const vector<T>& getAll() const { return items; }
+    typename vector<T>::const_iterator begin() const { return items.begin(); }
+    typename vector<T>::const_iterator end() const { return items.end(); }
+    const T& operator[](size_t index) const { return items[index]; }
     size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+};
+
+class User;
+class Admin;
+class Employee;
+
+using UserRecord = variant<shared_ptr<Admin>, shared_ptr<Employee>>;
+
+//    .         ,
+//      ,       .
+class UsernameIndex {
+private:
+    struct Slot {
+        uint32_t hash = 0;
+        uint32_t id = EMPTY;
+    };
+
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+    static constexpr uint32_t DELETED = UINT32_MAX - 1;
+
+    const Repository<shared_ptr<Employee>>& employees;
+    const shared_ptr<Admin>& admin;
+    vector<Slot> slots;
+    size_t count;
+    size_t occupied;
+
+    static uint32_t hashKey(string_view key);
+    string_view keyOf(uint32_t id) const;
+    size_t findSlot(string_view key, uint32_t hash) const;
+    void rehash(size_t newCapacity);
+
+public:
+    static constexpr uint32_t ADMIN_ID = UINT32_MAX - 2;
+
+    UsernameIndex(const Repository<shared_ptr<Employee>>& records, const shared_ptr<Admin>& administrator);
+    bool insert(string_view username, uint32_t id);
+    bool erase(string_view username);
+    optional<UserRecord> find(string_view username) const;
+    bool contains(string_view username) const;
+    void reserve(size_t users);
+    void clear();
+    size_t size() const { return count; }
+    size_t memoryBytes() const { return slots.capacity() * sizeof(Slot); }
 };
 
 class Date;
 ostream& operator<<(ostream& os, const Date& date);
 
-class Date {
+class AsOfDate {
 private:
-    int day, month, year;
+    int year, month, day;
+public:
+    AsOfDate(int y, int m, int d = 1);
+    static AsOfDate today();
+
+    int getYear() const { return year; }
+    int getMonth() const { return month; }
+    int getDay() const { return day; }
+    int monthIndex() const { return year * 12 + month - 1; }
+    bool operator==(const AsOfDate& other) const {
+        return year == other.year && month == other.month && day == other.day;
+    }
+};
 
-    friend ostream& operator<<(ostream& os, const Date& date);
+class Date {
+public:
+    struct Civil {
+        int year, month, day;
+    };
+
+private:
+    int32_t days;
 
 public:
-    Date(int d = 1, int m = 1, int y = 2000);
+    static constexpr size_t MAX_TEXT = 24;
+
+    constexpr Date(int d = 1, int m = 1, int y = 2000) : days(daysFromCivil(y, m, d)) {}
+
+    static constexpr bool isLeapYear(int y) {
+        return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    }
+
+    static constexpr int daysInMonth(int y, int m) {
+        return m == 2 ? (isLeapYear(y) ? 29 : 28) : (m == 4 || m == 6 || m == 9 || m == 11) ? 30 : 31;
+    }
+
+    static constexpr int MIN_YEAR = 1900;
+    static constexpr int MAX_YEAR = 2100;
+
+    static constexpr bool isValid(int d, int m, int y) {
+        return y >= MIN_YEAR && y <= MAX_YEAR && m >= 1 && m <= 12 && d >= 1 && d <= daysInMonth(y, m);
+    }
+
+    static constexpr int32_t daysFromCivil(int y, int m, int d) {
+        y -= m <= 2;
+        int era = (y >= 0 ? y : y - 399) / 400;
+        int yearOfEra = y - era * 400;
+        int dayOfYear = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    static constexpr Civil civilFromDays(int32_t serial) {
+        serial += 719468;
+        int era = (serial >= 0 ? serial : serial - 146096) / 146097;
+        int dayOfEra = serial - era * 146097;
+        int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        int mp = (5 * dayOfYear + 2) / 153;
+        int d = dayOfYear - (153 * mp + 2) / 5 + 1;
+        int m = mp < 10 ? mp + 3 : mp - 9;
+        return { yearOfEra + era * 400 + (m <= 2), m, d };
+    }
+
+    static constexpr Date fromSerial(int32_t serial) {
+        Date date;
+        date.days = serial;
+        return date;
+    }
+    constexpr int32_t serial() const { return days; }
+    constexpr Civil civil() const { return civilFromDays(days); }
+    constexpr int getDay() const { return civil().day; }
+    constexpr int getMonth() const { return civil().month; }
+    constexpr int getYear() const { return civil().year; }
+    constexpr int monthIndex() const { return civil().year * 12 + civil().month - 1; }
+
+    constexpr bool operator==(const Date& other) const { return days == other.days; }
+    constexpr bool operator!=(const Date& other) const { return days != other.days; }
+    constexpr bool operator<(const Date& other) const { return days < other.days; }
+
+    size_t format(char* buffer, size_t size) const;
+    static bool parse(string_view text, Date& date);
     string toString() const;
     static Date fromString(const string& dateStr);
     int calculateExperience() const;
-
-    static const int MIN_YEAR;
+    int calculateExperience(const AsOfDate& asOf) const;
+    static int experienceBetween(int hireMonthIndex, int asOfMonthIndex);
 };
 
 ostream& operator<<(ostream& os, const Date& date);
@@ -54,6 +268,8 @@ private:
 public:
     KPI(double pc = 0, double cq = 0, double tw = 0, double in = 0);
     double getTotalKPI() const;
+    static void getTotalKPIBatch(const double* pc, const double* cq, const double* tw,
+        const double* in, double* total, size_t count);
     double getProjectCompletion() const;
     double getCodeQuality() const;
     double getTeamwork() const;
@@ -80,8 +296,12 @@ private:
     double kpiCoefficient;
     double experienceCoefficient;
     double maxExperienceBonus;
+    uint64_t version;
+
+    static atomic<uint64_t> versionCounter;
 public:
     BonusFormula(double kpiCoeff = 0.2, double expCoeff = 0.005, double maxExpBonus = 0.05);
+    uint64_t getVersion() const { return version; }
     double getKpiCoefficient() const;
     double getExperienceCoefficient() const;
     double getMaxExperienceBonus() const;
@@ -89,6 +309,8 @@ public:
     void setExperienceCoefficient(double coeff);
     void setMaxExperienceBonus(double bonus);
     double calculateBonus(double salary, double kpiScore, int experience) const;
+    void calculateBonusBatch(const double* salary, const double* kpiScore,
+        const int* experience, double* bonus, size_t count) const;
     void displayFormula() const;
     string toString() const;
     static BonusFormula fromString(const string& str);
@@ -98,92 +320,242 @@ public:
 
 class User {
 protected:
-    string username;
-    string password;
-    string fullName;
-    string role;
+    // ,  ,         ,    .
+    //      ,        .
+    const char* text;
+    StringArena* strings;
+    uint16_t lengths[4];
     bool isApproved;
 
-    static int userCount;
+    static atomic<int> userCount;
+
+    ~User();
+    //      (    ),     .
+    void storeFields(StringArena& arena, string_view uname, string_view hash, string_view name, string_view r);
 
 public:
-    User(string uname = "", string pwd = "", string name = "",
-        string r = "user", bool approved = false);
-    virtual ~User();
-
-    string getUsername() const;
-    string getPassword() const;
-    string getFullName() const;
-    string getRole() const;
+    static constexpr size_t MAX_FIELD = UINT16_MAX;
+
+    User(StringArena& arena, string_view uname = "", string_view pwd = "", string_view name = "",
+        string_view r = "user", bool approved = false);
+    User(StringArena& arena, string_view uname, PasswordHash hash, string_view name, string_view r, bool approved);
+
+    string_view getUsername() const { return string_view(text, lengths[0]); }
+    string_view getPassword() const { return string_view(text + lengths[0], lengths[1]); }
+    string_view getFullName() const { return string_view(text + lengths[0] + lengths[1], lengths[2]); }
+    string_view getRole() const { return string_view(text + lengths[0] + lengths[1] + lengths[2], lengths[3]); }
     bool getIsApproved() const;
 
-    void setUsername(const string& uname);
-    void setPassword(const string& pwd);
-    void setFullName(const string& name);
-    void setRole(const string& r);
+    void setUsername(string_view uname);
+    void setPassword(string_view pwd);
+    void setPasswordHash(string_view hash);
+    void setFullName(string_view name);
+    void setRole(string_view r);
     void setIsApproved(bool approved);
 
-    virtual bool verifyPassword(const string& pwd) const;
-    virtual void showMenu() = 0;
-    virtual string toFileString() const = 0;
+    bool verifyPassword(string_view pwd) const;
 
     static int getUserCount();
 };
 
 class Employee : public User {
 private:
-    string department, position;
-    double salary;
-    Date hireDate;
-    KPI kpi;
+    mutable atomic<bool> cacheBusy;
+    uint16_t kpiHundredths[4];
+    int32_t hireDate;
+    uint32_t departmentId, positionId;
+    int64_t salaryMinor;
+    uint32_t version;
+
+    //     32 :      .
+    mutable uint32_t cachedVersion;
+    mutable uint32_t cachedFormulaVersion;
+    mutable int cachedAsOfMonth;
+    mutable double cachedBonus;
 
 public:
-    Employee(string uname = "", string pwd = "", string name = "",
-        string dept = "", string pos = "", double sal = 0, Date hire = Date());
-
-    string getDepartment() const;
-    string getPosition() const;
+    Employee(StringArena& arena, string_view uname = "", string_view pwd = "", string_view name = "",
+        string_view dept = "", string_view pos = "", double sal = 0, Date hire = Date());
+    Employee(StringArena& arena, string_view uname, string_view pwd, string_view name,
+        uint32_t deptId, uint32_t posId, double sal, Date hire);
+    Employee(StringArena& arena, string_view uname, PasswordHash hash, string_view name,
+        uint32_t deptId, uint32_t posId, double sal, Date hire);
+
+    const string& getDepartment() const;
+    const string& getPosition() const;
+    uint32_t getDepartmentId() const { return departmentId; }
+    uint32_t getPositionId() const { return positionId; }
     double getSalary() const;
     Date getHireDate() const;
     KPI getKPI() const;
+    const uint16_t* getKPIHundredths() const { return kpiHundredths; }
 
-    void setDepartment(const string& dept);
-    void setPosition(const string& pos);
+    void setDepartment(string_view dept);
+    void setPosition(string_view pos);
     void setSalary(double sal);
     void setHireDate(Date hire);
     void setKPI(const KPI& k);
 
     double calculateBonus(const BonusFormula& formula) const;
+    double calculateBonus(const BonusFormula& formula, const AsOfDate& asOf) const;
     int getExperience() const;
-    void showMenu() override;
-    string toFileString() const override;
-    void displayDetailedInfo(const BonusFormula& formula) const;
+    int getExperience(const AsOfDate& asOf) const;
+    void showMenu(const StoreLock& lock);
+    string toFileString() const;
+    void displayDetailedInfo(const BonusFormula& formula, const AsOfDate& asOf) const;
+
+    static constexpr int SALARY_SCALE = 100;
+    static constexpr int KPI_SCALE = 100;
 
     void updateSalary(double& newSalary, const string& reason) {
         cout << " : " << reason << endl;
-        salary = newSalary;
+        setSalary(newSalary);
     }
 
     template<typename T>
     T getSalaryAs() const {
-        return static_cast<T>(salary);
+        return static_cast<T>(getSalary());
     }
 
     friend void printEmployeeInfo(const Employee& emp);
 };
 
 inline void printEmployeeInfo(const Employee& emp) {
-    cout << ": " << emp.fullName << " (" << emp.department << ")";
+    cout << ": " << emp.getFullName() << " (" << emp.getDepartment() << ")";
 }
 
+//   .          ,
+// KPI    ,    .
+struct VersionRow {
+    Handle handle;
+    const char* text = nullptr;
+    double salary = 0;
+    uint32_t departmentId = 0;
+    uint32_t positionId = 0;
+    int32_t hireDay = 0;
+    uint32_t nameOffset = 0;
+    uint16_t kpi[4] = {};
+    uint16_t usernameLength = 0;
+    uint16_t nameLength = 0;
+
+    string_view username() const { return string_view(text, usernameLength); }
+    string_view fullName() const { return string_view(text + nameOffset, nameLength); }
+    double kpiValue(int index) const { return (double)kpi[index] / Employee::KPI_SCALE; }
+    double totalKPI() const;
+    int hireMonth() const { return Date::fromSerial(hireDay).monthIndex(); }
+};
+
+struct VersionColumns {
+    vector<double> salary;
+    vector<double> totalKPI;
+    vector<int> experience;
+    vector<double> bonus;
+};
+
+class StoreVersion {
+private:
+    vector<shared_ptr<const vector<VersionRow>>> chunks;
+    //        -    .
+    vector<shared_ptr<const vector<uint32_t>>> departments;
+    size_t rowCount;
+    uint64_t versionNumber;
+    BonusFormula formula;
+    AsOfDate asOf;
+    bool asOfPinned;
+    PayrollSummary summary;
+    //       ;    .
+    shared_ptr<const StringArena> strings;
+    mutable mutex derivedMutex;
+    mutable shared_ptr<const VersionColumns> derived;
+
+public:
+    static constexpr size_t CHUNK_ROWS = 256;
+
+    StoreVersion(vector<shared_ptr<const vector<VersionRow>>> rowChunks,
+        vector<shared_ptr<const vector<uint32_t>>> departmentRows, size_t rows, uint64_t number,
+        const BonusFormula& f, const AsOfDate& date, bool pinned, PayrollSummary stats,
+        shared_ptr<const StringArena> arena);
+
+    size_t size() const { return rowCount; }
+    bool empty() const { return rowCount == 0; }
+    const VersionRow& operator[](size_t row) const { return (*chunks[row / CHUNK_ROWS])[row % CHUNK_ROWS]; }
+    const vector<uint32_t>& departmentRows(uint32_t departmentId) const;
+    uint64_t number() const { return versionNumber; }
+    const BonusFormula& getFormula() const { return formula; }
+    const AsOfDate& getAsOf() const { return asOf; }
+    bool isAsOfPinned() const { return asOfPinned; }
+    const PayrollSummary& getSummary() const { return summary; }
+    shared_ptr<const VersionColumns> columns() const;
+};
+
+class VersionBuilder {
+private:
+    vector<shared_ptr<vector<VersionRow>>> chunks;
+    vector<char> shared;
+    size_t rowCount;
+    uint64_t nextNumber;
+
+    VersionRow& writable(size_t row);
+
+public:
+    VersionBuilder();
+
+    size_t size() const { return rowCount; }
+    const VersionRow& row(size_t index) const {
+        return (*chunks[index / StoreVersion::CHUNK_ROWS])[index % StoreVersion::CHUNK_ROWS];
+    }
+    void append(const VersionRow& row);
+    void assign(size_t row, const VersionRow& value);
+    void erase(size_t row);
+    void clear();
+    size_t memoryBytes() const;
+    shared_ptr<const StoreVersion> publish(const BonusFormula& formula, const AsOfDate& asOf,
+        bool asOfPinned, PayrollSummary summary, shared_ptr<const StringArena> strings,
+        vector<shared_ptr<const vector<uint32_t>>> departmentRows);
+};
+
+//     ;        .
+class DepartmentView {
+private:
+    shared_ptr<const StoreVersion> version;
+    const vector<uint32_t>* rows;
+
+public:
+    class iterator {
+    private:
+        const StoreVersion* version;
+        vector<uint32_t>::const_iterator position;
+    public:
+        iterator(const StoreVersion* v, vector<uint32_t>::const_iterator pos)
+            : version(v), position(pos) {}
+        const VersionRow& operator*() const { return (*version)[*position]; }
+        iterator& operator++() { ++position; return *this; }
+        bool operator!=(const iterator& other) const { return position != other.position; }
+        bool operator==(const iterator& other) const { return position == other.position; }
+    };
+
+    DepartmentView(shared_ptr<const StoreVersion> v, uint32_t departmentId)
+        : version(move(v)), rows(&version->departmentRows(departmentId)) {}
+
+    iterator begin() const { return iterator(version.get(), rows->begin()); }
+    iterator end() const { return iterator(version.get(), rows->end()); }
+    size_t size() const { return rows->size(); }
+    bool empty() const { return rows->empty(); }
+    const VersionRow& operator[](size_t i) const { return (*version)[(*rows)[i]]; }
+};
+
 class Admin : public User {
 public:
-    Admin(string uname = "admin", string pwd = "admin123",
-        string name = " ");
-    void showMenu() override;
-    string toFileString() const override;
+    Admin(StringArena& arena, string_view uname = "admin", string_view pwd = "admin123",
+        string_view name = " ");
+    void showMenu();
+    string toFileString() const;
 };
 
+inline const User& recordUser(const UserRecord& record) {
+    return visit([](const auto& user) -> const User& { return *user; }, record);
+}
+
 class AdminHelper {
 public:
     static void showAdminInfo(const Admin& admin) {
@@ -201,12 +573,68 @@ T calculateAverage(const vector<T>& items) {
 
 class BonusSystem {
 private:
-    vector<shared_ptr<User>> users;
-    vector<shared_ptr<Employee>> employees;
-    vector<shared_ptr<User>> pendingRegistrations;
+    RecordPool employeePool;
+    shared_ptr<StringArena> strings;
+    shared_ptr<Admin> admin;
+    Repository<shared_ptr<Employee>> employees;
+    vector<shared_ptr<Employee>> pendingRegistrations;
     string dataFile;
     string formulaFile;
+    string snapshotFile;
     BonusFormula formula;
+    bool asOfPinned;
+    AsOfDate pinnedAsOf;
+    UsernameIndex usernameIndex;
+    ChangeJournal journal;
+    //            .
+    TrigramIndex nameIndex;
+    bool nameIndexValid;
+    DepartmentIndex departments;
+    PayrollAggregates aggregates;
+    bool aggregatesValid;
+    uint64_t aggregatesFormulaVersion;
+    int aggregatesMonth;
+    PayrollModel payrollModel;
+    bool payrollModelValid;
+    int payrollModelMonth;
+    StoreLock storeLock;
+    //     ;  ,      commitMutex.
+    mutex commitMutex;
+    VersionBuilder versions;
+    //     storeLock,    ,    .
+    mutable mutex publishedMutex;
+    shared_ptr<const StoreVersion> published;
+
+    enum class Derived { NameIndex, PayrollModel };
+
+    bool hasEmployees() const;
+    bool derivedFresh(Derived need, const AsOfDate& asOf) const;
+    StoreLock::ReadGuard readDerived(Derived need);
+    VersionRow versionRow(size_t row) const;
+    string nameKey(size_t row) const;
+    void publishVersion();
+    shared_ptr<const StoreVersion> pinVersion();
+    void printEmployeeTable(const StoreVersion& version);
+    void writeFormula();
+    void writeData();
+    void attachEmployee(shared_ptr<Employee> emp);
+    void detachEmployee(size_t index);
+    void rebuildRows();
+    void indexRow(size_t row);
+    void unindexRow(size_t row, const VersionRow& old);
+    void syncRow(size_t row);
+    StoreLock::EditGuard lockEmployee(Handle handle, optional<uint32_t> moveTo = nullopt);
+    void commitRow(Handle handle);
+    double rowBonus(const VersionRow& row, int asOfMonth) const;
+    void rowBonuses(size_t first, size_t count, int asOfMonth, double* bonus, double* totalKPI) const;
+    void buildNameIndex();
+    void ensureAggregates(const AsOfDate& asOf);
+    void ensurePayrollModel(const AsOfDate& asOf);
+    void showPayrollForecast();
+    void sweepBonusFormula();
+    void replayJournal();
+    void compactJournalIfNeeded();
+    void reportLoadErrors(const vector<LoadError>& errors);
 
 public:
     BonusSystem(string filename = "users.txt", string formulaFilename = "formula.txt");
@@ -216,11 +644,14 @@ public:
     void loadFormula();
     void saveFormula();
     BonusFormula& getFormula();
+    AsOfDate currentAsOf() const;
+    void setAsOfDate(const AsOfDate& asOf);
+    void resetAsOfDate();
     void loadData();
     void saveData();
 
-    shared_ptr<User> authenticate(const string& username, const string& password);
-    bool usernameExists(const string& username);
+    optional<UserRecord> authenticate(const string& username, const string& password, string& fullName);
+    bool usernameExists(string_view username);
     void registerUser();
     void approveRegistration();
     void addUser();
@@ -232,22 +663,19 @@ public:
     void editEmployeeData();
     void calculateAndViewBonuses();
     void configureBonusFormula();
+    PayrollForecast forecastPayroll(const BonusFormula& candidate);
 
     string getHiddenPassword();
-    void displayAllEmployees();
+    vector<Handle> displayAllEmployees();
+    void reportMemoryUsage() const;
+    void reportLockUsage() const;
+    const StoreLock& getStoreLock() const;
 
-    vector<shared_ptr<Employee>>& getEmployees();
-    vector<shared_ptr<User>>& getPendingRegistrations();
+    //       ,   .
+    shared_ptr<const StoreVersion> getEmployees();
+    vector<shared_ptr<Employee>> getPendingRegistrations() const;
 
-    vector<shared_ptr<Employee>> operator()(const string& dept) {
-        vector<shared_ptr<Employee>> result;
-        for (const auto& emp : employees) {
-            if (emp->getDepartment() == dept) {
-                result.push_back(emp);
-            }
-        }
-        return result;
-    }
+    DepartmentView operator()(const string& dept);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include "data_loader.h"
+#include "classes.h"
+#include "record_pool.h"
+#include <charconv>
+#include <thread>
+#include <algorithm>
+#include <iterator>
+#include <deque>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : data(nullptr), length(0), fileHandle(nullptr), mappingHandle(nullptr) {}
+#else
+MappedFile::MappedFile() : data(nullptr), length(0), fd(-1) {}
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    fileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(size.QuadPart);
+    if (length == 0) return true;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+    data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) return true;
+
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    data = mapped == MAP_FAILED ? nullptr : static_cast<const char*>(mapped);
+#endif
+    if (!data) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (data) munmap(const_cast<char*>(data), length);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    data = nullptr;
+    length = 0;
+}
+
+void MappedFile::release(string_view consumed) const {
+    if (!data || consumed.empty()) return;
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t page = info.dwPageSize;
+#else
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+    uintptr_t begin = ((uintptr_t)consumed.data() + page - 1) / page * page;
+    uintptr_t end = ((uintptr_t)consumed.data() + consumed.size()) / page * page;
+    if (begin >= end) return;
+#ifdef _WIN32
+    //  ,   , VirtualUnlock      .
+    VirtualUnlock((void*)begin, end - begin);
+#else
+    madvise((void*)begin, end - begin, MADV_DONTNEED);
+#endif
+}
+
+namespace DataLoader {
+    namespace {
+        const size_t EMPLOYEE_FIELDS = 13;
+
+        //     : , , , ,   .
+        bool isAdminLine(string_view line) {
+            vector<string_view> fields;
+            size_t start = 0;
+            while (true) {
+                size_t comma = line.find(',', start);
+                fields.push_back(line.substr(start, comma == string_view::npos ? string_view::npos : comma - start));
+                if (comma == string_view::npos) break;
+                start = comma + 1;
+            }
+            return (fields.size() >= 4 && fields[3] == "admin") ||
+                (fields.size() >= 6 && fields[fields.size() - 3] == "admin");
+        }
+
+        //    LOAD_SLICE  ;      .
+        size_t parseSlices(string_view text, LoadResult& result, ParseContext& context, const MappedFile* file) {
+            size_t lines = 0;
+            size_t start = 0;
+            while (start < text.size()) {
+                size_t end = min(start + LOAD_SLICE, text.size());
+                if (end < text.size()) {
+                    size_t newline = text.find('\n', end);
+                    end = newline == string_view::npos ? text.size() : newline + 1;
+                }
+                string_view slice = text.substr(start, end - start);
+                lines += parseLines(slice, lines + 1, result, context);
+                if (file) file->release(slice);
+                start = end;
+            }
+            return lines;
+        }
+    }
+
+    bool parseNumber(string_view text, double& value) {
+        const char* end = text.data() + text.size();
+        auto result = from_chars(text.data(), end, value);
+        return result.ec == errc() && result.ptr == end;
+    }
+
+    void appendEscaped(string& line, string_view field) {
+        for (char c : field) {
+            switch (c) {
+            case '\\': line.append("\\\\"); break;
+            case '\n': line.append("\\n"); break;
+            case '\r': line.append("\\r"); break;
+            default: line.push_back(c);
+            }
+        }
+    }
+
+    string unescapeField(string_view field) {
+        string result;
+        result.reserve(field.size());
+        for (size_t i = 0; i < field.size(); i++) {
+            char next = i + 1 < field.size() ? field[i + 1] : '\0';
+            if (field[i] == '\\' && (next == '\\' || next == 'n' || next == 'r')) {
+                result.push_back(next == 'n' ? '\n' : next == 'r' ? '\r' : '\\');
+                i++;
+            }
+            else {
+                result.push_back(field[i]);
+            }
+        }
+        return result;
+    }
+
+    ParseContext::ParseContext(StringArena& arena, RecordPool* recordPool)
+        : strings(arena), pool(recordPool), departments(StringDictionary::departments()),
+        positions(StringDictionary::positions()) {}
+
+    shared_ptr<Employee> parseEmployee(string_view line, string& error, StringArena& strings, RecordPool* pool) {
+        ParseContext context(strings, pool);
+        return parseEmployee(line, error, context);
+    }
+
+    shared_ptr<Employee> parseEmployee(string_view line, string& error, ParseContext& context) {
+        size_t count = std::count(line.begin(), line.end(), ',') + 1;
+        if (count < EMPLOYEE_FIELDS) {
+            if (isAdminLine(line)) return nullptr;
+            error = "   " + to_string(EMPLOYEE_FIELDS) + " ,  " + to_string(count);
+            return nullptr;
+        }
+
+        //      : XOR  'y'  ','.   
+        //   ,      ,      .
+        string_view fields[EMPLOYEE_FIELDS];
+        size_t end = line.size();
+        for (size_t i = EMPLOYEE_FIELDS - 1; i >= 2; i--) {
+            size_t comma = line.rfind(',', end - 1);
+            fields[i] = line.substr(comma + 1, end - comma - 1);
+            end = comma;
+        }
+        size_t first = line.find(',');
+        fields[0] = line.substr(0, first);
+        fields[1] = line.substr(first + 1, end - first - 1);
+
+        if (fields[3] == "admin") {
+            return nullptr;
+        }
+
+        for (size_t i = 0; i < 3; i++) {
+            if (fields[i].size() > User::MAX_FIELD) {
+                error = "  " + to_string(User::MAX_FIELD) + " ";
+                return nullptr;
+            }
+        }
+
+        double salary;
+        if (!parseNumber(fields[7], salary)) {
+            error = "  \"" + string(fields[7]) + "\"";
+            return nullptr;
+        }
+
+        Date hireDate;
+        if (!Date::parse(fields[8], hireDate)) {
+            error = "   \"" + string(fields[8]) + "\"";
+            return nullptr;
+        }
+
+        double kpi[4];
+        for (int i = 0; i < 4; i++) {
+            if (!parseNumber(fields[9 + i], kpi[i])) {
+                error = "  KPI \"" + string(fields[9 + i]) + "\"";
+                return nullptr;
+            }
+        }
+
+        string password;
+        if (fields[1].find('\\') != string_view::npos) {
+            password = unescapeField(fields[1]);
+            fields[1] = password;
+        }
+
+        auto emp = makePooled<Employee>(context.pool, context.strings, fields[0], fields[1], fields[2],
+            context.departments.intern(fields[5]), context.positions.intern(fields[6]), salary, hireDate);
+        emp->setIsApproved(fields[4] == "1");
+        emp->setKPI(KPI(kpi[0], kpi[1], kpi[2], kpi[3]));
+        return emp;
+    }
+
+    size_t parseLines(string_view text, size_t firstLine, LoadResult& result, ParseContext& context) {
+        size_t lineNumber = firstLine;
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == string_view::npos) end = text.size();
+
+            string_view line = text.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+            if (!line.empty()) {
+                string error;
+                auto emp = parseEmployee(line, error, context);
+                if (emp) {
+                    result.employees.push_back(emp);
+                }
+                else if (!error.empty()) {
+                    result.errors.push_back({ lineNumber, error });
+                }
+            }
+
+            start = end + 1;
+            lineNumber++;
+        }
+        return lineNumber - firstLine;
+    }
+
+    void parseParallel(string_view text, LoadResult& result, StringArena& strings, RecordPool* pool,
+        const MappedFile* file) {
+        size_t workers = thread::hardware_concurrency();
+        if (text.size() < PARALLEL_LOAD_THRESHOLD || workers < 2) {
+            RecordPool::Batch batch(pool);
+            ParseContext context(strings, pool);
+            parseSlices(text, result, context, file);
+            return;
+        }
+
+        vector<string_view> chunks;
+        size_t chunkSize = text.size() / workers + 1;
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = min(start + chunkSize, text.size());
+            if (end < text.size()) {
+                size_t newline = text.find('\n', end);
+                end = newline == string_view::npos ? text.size() : newline + 1;
+            }
+            chunks.push_back(text.substr(start, end - start));
+            start = end;
+        }
+
+        //      ,      join;
+        //           .
+        deque<StringArena> arenas;
+        for (size_t i = 0; i < chunks.size(); i++) arenas.emplace_back(&strings);
+
+        vector<LoadResult> partial(chunks.size());
+        vector<size_t> lineCounts(chunks.size());
+        vector<thread> threads;
+        for (size_t i = 0; i < chunks.size(); i++) {
+            threads.emplace_back([&chunks, &partial, &lineCounts, &arenas, pool, file, i]() {
+                RecordPool::Batch batch(pool);
+                ParseContext context(arenas[i], pool);
+                lineCounts[i] = parseSlices(chunks[i], partial[i], context, file);
+            });
+        }
+        for (auto& t : threads) t.join();
+        for (auto& arena : arenas) strings.adopt(arena);
+
+        size_t total = 0;
+        for (const auto& part : partial) total += part.employees.size();
+        result.employees.reserve(result.employees.size() + total);
+
+        size_t lineOffset = 0;
+        for (size_t i = 0; i < partial.size(); i++) {
+            move(partial[i].employees.begin(), partial[i].employees.end(), back_inserter(result.employees));
+            for (auto& error : partial[i].errors) {
+                error.line += lineOffset;
+                result.errors.push_back(move(error));
+            }
+            lineOffset += lineCounts[i];
+        }
+    }
+
+    LoadResult loadFile(const string& path, StringArena& strings, RecordPool* pool) {
+        LoadResult result;
+        MappedFile file;
+        if (!file.open(path)) {
+            return result;
+        }
+        result.fileFound = true;
+        parseParallel(file.view(), result, strings, pool, &file);
+        return result;
+    }
+}
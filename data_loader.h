@@ -0,0 +1,80 @@
+#ifndef DATA_LOADER_H
+#define DATA_LOADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include "dictionary.h"
+using namespace std;
+
+class Employee;
+class RecordPool;
+class StringArena;
+
+class MappedFile {
+private:
+    const char* data;
+    size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& path);
+    void close();
+    string_view view() const { return string_view(data, length); }
+    //     :       ,
+    //          .
+    void release(string_view consumed) const;
+};
+
+struct LoadError {
+    size_t line;
+    string message;
+};
+
+const size_t PARALLEL_LOAD_THRESHOLD = 4 << 20;
+const size_t LOAD_SLICE = 4 << 20;
+
+struct LoadResult {
+    bool fileFound = false;
+    vector<shared_ptr<Employee>> employees;
+    vector<LoadError> errors;
+};
+
+namespace DataLoader {
+    bool parseNumber(string_view text, double& value);
+    //       '\\', '\n'  '\r',     .
+    void appendEscaped(string& line, string_view field);
+    string unescapeField(string_view field);
+    // ,      .      :
+    //   ,        ,      .
+    struct ParseContext {
+        StringArena& strings;
+        RecordPool* pool;
+        StringDictionary::Cache departments;
+        StringDictionary::Cache positions;
+
+        ParseContext(StringArena& arena, RecordPool* recordPool);
+    };
+
+    shared_ptr<Employee> parseEmployee(string_view line, string& error, ParseContext& context);
+    shared_ptr<Employee> parseEmployee(string_view line, string& error, StringArena& strings,
+        RecordPool* pool = nullptr);
+    size_t parseLines(string_view text, size_t firstLine, LoadResult& result, ParseContext& context);
+    // file,  ,  ,    text:    LOAD_SLICE .
+    void parseParallel(string_view text, LoadResult& result, StringArena& strings, RecordPool* pool = nullptr,
+        const MappedFile* file = nullptr);
+    LoadResult loadFile(const string& path, StringArena& strings, RecordPool* pool = nullptr);
+}
+
+#endif
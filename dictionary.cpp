@@ -0,0 +1,54 @@
+#include "dictionary.h"
+#include <mutex>
+
+uint32_t StringDictionary::intern(string_view value) {
+    {
+        shared_lock<shared_mutex> lock(mutex);
+        auto found = ids.find(value);
+        if (found != ids.end()) return found->second;
+    }
+
+    unique_lock<shared_mutex> lock(mutex);
+    auto found = ids.find(value);
+    if (found != ids.end()) return found->second;
+
+    uint32_t id = (uint32_t)names.size();
+    names.emplace_back(value);
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+int StringDictionary::find(string_view value) const {
+    shared_lock<shared_mutex> lock(mutex);
+    auto found = ids.find(value);
+    return found == ids.end() ? -1 : (int)found->second;
+}
+
+const string& StringDictionary::name(uint32_t id) const {
+    shared_lock<shared_mutex> lock(mutex);
+    return names[id];
+}
+
+size_t StringDictionary::size() const {
+    shared_lock<shared_mutex> lock(mutex);
+    return names.size();
+}
+
+uint32_t StringDictionary::Cache::intern(string_view value) {
+    auto found = ids.find(value);
+    if (found != ids.end()) return found->second;
+
+    uint32_t id = dictionary.intern(value);
+    ids.emplace(dictionary.name(id), id);
+    return id;
+}
+
+StringDictionary& StringDictionary::departments() {
+    static StringDictionary dictionary;
+    return dictionary;
+}
+
+StringDictionary& StringDictionary::positions() {
+    static StringDictionary dictionary;
+    return dictionary;
+}
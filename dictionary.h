@@ -0,0 +1,40 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+using namespace std;
+
+class StringDictionary {
+private:
+    deque<string> names;
+    unordered_map<string_view, uint32_t> ids;
+    mutable shared_mutex mutex;
+
+public:
+    uint32_t intern(string_view value);
+    int find(string_view value) const;
+    const string& name(uint32_t id) const;
+    size_t size() const;
+
+    //       :     
+    //       .
+    class Cache {
+    private:
+        StringDictionary& dictionary;
+        unordered_map<string_view, uint32_t> ids;
+
+    public:
+        explicit Cache(StringDictionary& d) : dictionary(d) {}
+        uint32_t intern(string_view value);
+    };
+
+    static StringDictionary& departments();
+    static StringDictionary& positions();
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "journal.h"
+#include "classes.h"
+#include <sstream>
+#include <filesystem>
+
+const size_t ChangeJournal::COMPACTION_THRESHOLD = 1 << 20;
+
+ChangeJournal::ChangeJournal(const string& filename) : path(filename), bytes(0) {}
+
+void ChangeJournal::append(char tag, const string& payload) {
+    lock_guard<mutex> lock(appendMutex);
+    if (!out.is_open()) {
+        out.open(path, ios::app | ios::binary);
+    }
+    out << tag << ',' << payload << '\n';
+    out.flush();
+    bytes += payload.size() + 3;
+}
+
+void ChangeJournal::recordAdd(const Employee& emp) {
+    append('A', emp.toFileString());
+}
+
+void ChangeJournal::recordDelete(string_view username) {
+    append('D', string(username));
+}
+
+void ChangeJournal::recordName(string_view username, string_view fullName) {
+    append('N', string(username).append(",").append(fullName));
+}
+
+void ChangeJournal::recordKPI(string_view username, const KPI& kpi) {
+    append('K', string(username) + "," + to_string(kpi.getProjectCompletion()) + "," +
+        to_string(kpi.getCodeQuality()) + "," + to_string(kpi.getTeamwork()) + "," +
+        to_string(kpi.getInnovation()));
+}
+
+void ChangeJournal::recordSalary(string_view username, double salary) {
+    append('S', string(username) + "," + to_string(salary));
+}
+
+void ChangeJournal::recordHireDate(string_view username, const Date& hireDate) {
+    append('H', string(username) + "," + hireDate.toString());
+}
+
+void ChangeJournal::recordPosition(string_view username, string_view department, string_view position) {
+    append('P', string(username).append(",").append(department).append(",").append(position));
+}
+
+vector<ChangeRecord> ChangeJournal::load() {
+    vector<ChangeRecord> records;
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        bytes = 0;
+        return records;
+    }
+
+    string line;
+    size_t total = 0;
+    bool torn = false;
+    while (getline(file, line)) {
+        if (file.eof()) {
+            torn = true;
+            break;
+        }
+        total += line.size() + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.size() < 2 || line[1] != ',') continue;
+
+        ChangeRecord record;
+        switch (line[0]) {
+        case 'A': record.type = ChangeType::Add; break;
+        case 'D': record.type = ChangeType::Delete; break;
+        case 'N': record.type = ChangeType::SetName; break;
+        case 'K': record.type = ChangeType::SetKPI; break;
+        case 'S': record.type = ChangeType::SetSalary; break;
+        case 'H': record.type = ChangeType::SetHireDate; break;
+        case 'P': record.type = ChangeType::SetPosition; break;
+        default: continue;
+        }
+
+        record.payload = line.substr(2);
+        stringstream ss(record.payload);
+        string token;
+        while (getline(ss, token, ',')) {
+            record.fields.push_back(token);
+        }
+        records.push_back(record);
+    }
+    file.close();
+
+    if (torn) {
+        error_code ec;
+        filesystem::resize_file(path, total, ec);
+    }
+    bytes = total;
+    return records;
+}
+
+void ChangeJournal::clear() {
+    lock_guard<mutex> lock(appendMutex);
+    if (out.is_open()) out.close();
+    out.open(path, ios::trunc | ios::binary);
+    bytes = 0;
+}
@@ -0,0 +1,53 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+using namespace std;
+
+class Employee;
+class KPI;
+class Date;
+
+enum class ChangeType { Add, Delete, SetName, SetKPI, SetSalary, SetHireDate, SetPosition };
+
+struct ChangeRecord {
+    ChangeType type;
+    string payload;
+    vector<string> fields;
+};
+
+class ChangeJournal {
+private:
+    string path;
+    ofstream out;
+    //       .
+    mutex appendMutex;
+    atomic<size_t> bytes;
+
+    void append(char tag, const string& payload);
+
+public:
+    static const size_t COMPACTION_THRESHOLD;
+
+    ChangeJournal(const string& filename);
+
+    void recordAdd(const Employee& emp);
+    void recordDelete(string_view username);
+    void recordName(string_view username, string_view fullName);
+    void recordKPI(string_view username, const KPI& kpi);
+    void recordSalary(string_view username, double salary);
+    void recordHireDate(string_view username, const Date& hireDate);
+    void recordPosition(string_view username, string_view department, string_view position);
+
+    vector<ChangeRecord> load();
+    void clear();
+    size_t size() const { return bytes; }
+    bool needsCompaction() const { return bytes >= COMPACTION_THRESHOLD; }
+};
+
+#endif
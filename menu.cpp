@@ -1,5 +1,6 @@
 #include "menu.h"
 #include "input.h"
+#include "bonus_kernels.h"
 #include <iostream>
 #include <memory>
 using namespace std;
@@ -101,11 +102,15 @@ void adminMenu(BonusSystem& system) {
             cout << "\n--   C++ --" << endl;
 
             Repository<int> repo;
-            repo.add(100);
+            Handle first = repo.add(100);
             repo.add(200);
             cout << " :  = " << repo.size() << endl;
+            repo.remove(first);
+            cout << " :  = " << repo.size() << ",  "
+                << (repo.contains(first) ? "" : "") << endl;
 
-            auto testEmp = make_shared<Employee>("demo", "demo", " ");
+            StringArena demoStrings;
+            auto testEmp = make_shared<Employee>(demoStrings, "demo", "demo", " ");
             cout << " : " << testEmp->getFullName() << endl;
 
             cout << " : " << User::getUserCount() << endl;
@@ -113,10 +118,14 @@ void adminMenu(BonusSystem& system) {
             Date d(10, 10, 2020);
             cout << "  <<  Date: " << d << endl;
 
-            Employee emp("test", "test", "");
+            Employee emp(demoStrings, "test", "test", "");
             printEmployeeInfo(emp);
             cout << endl;
 
+            cout << "  : " << BonusKernels::levelName(BonusKernels::getLevel()) << endl;
+            system.reportMemoryUsage();
+            system.reportLockUsage();
+
             break;
         }
         case 0:
@@ -126,6 +135,13 @@ void adminMenu(BonusSystem& system) {
     } while (choice != 0);
 }
 
+struct SessionVisitor {
+    BonusSystem& system;
+
+    void operator()(const shared_ptr<Admin>&) const { adminMenu(system); }
+    void operator()(const shared_ptr<Employee>& emp) const { emp->showMenu(system.getStoreLock()); }
+};
+
 void mainMenu(BonusSystem& system) {
     int choice;
     do {
@@ -146,18 +162,11 @@ void mainMenu(BonusSystem& system) {
             cout << ": ";
             password = system.getHiddenPassword();
 
-            auto user = system.authenticate(username, password);
+            string fullName;
+            auto user = system.authenticate(username, password, fullName);
             if (user) {
-                cout << "\n , " << user->getFullName() << "!" << endl;
-                if (user->getRole() == "admin") {
-                    adminMenu(system);
-                }
-                else {
-                    auto emp = dynamic_pointer_cast<Employee>(user);
-                    if (emp) {
-                        emp->showMenu();
-                    }
-                }
+                cout << "\n , " << fullName << "!" << endl;
+                visit(SessionVisitor{ system }, *user);
             }
             else {
                 cout << " !" << endl;
@@ -0,0 +1,179 @@
+#include "payroll_stats.h"
+#include "classes.h"
+#include <algorithm>
+
+const double PayrollAggregates::LOW_KPI_THRESHOLD = 70;
+
+void PayrollAggregates::offer(PayrollGroup& group, double bonus, string_view name) {
+    if (bonus < group.minBonus) {
+        group.minBonus = bonus;
+        group.worstName = name;
+    }
+    if (bonus >= group.maxBonus) {
+        group.maxBonus = bonus;
+        group.bestName = name;
+    }
+}
+
+void PayrollAggregates::add(uint32_t department, double salary, double bonus, double kpi, string_view name) {
+    if (department >= departments.size()) departments.resize(department + 1);
+    PayrollGroup& group = departments[department];
+    group.count++;
+    group.salarySum += salary;
+    group.bonusSum += bonus;
+    if (kpi < LOW_KPI_THRESHOLD) group.lowKpiCount++;
+    offer(group, bonus, name);
+}
+
+void PayrollAggregates::remove(uint32_t department, double salary, double bonus, double kpi) {
+    PayrollGroup& group = departments[department];
+    group.count--;
+    if (group.count == 0) {
+        group = PayrollGroup();
+        return;
+    }
+
+    group.salarySum -= salary;
+    group.bonusSum -= bonus;
+    if (kpi < LOW_KPI_THRESHOLD) group.lowKpiCount--;
+    if (bonus <= group.minBonus || bonus >= group.maxBonus) group.extremesStale = true;
+}
+
+void PayrollAggregates::resetExtremes(uint32_t department) {
+    PayrollGroup& group = departments[department];
+    group.minBonus = numeric_limits<double>::infinity();
+    group.maxBonus = -numeric_limits<double>::infinity();
+    group.worstName = group.bestName = string_view();
+    group.extremesStale = false;
+}
+
+void PayrollAggregates::offerExtreme(uint32_t department, double bonus, string_view name) {
+    offer(departments[department], bonus, name);
+}
+
+void PayrollAggregates::clear() {
+    departments.clear();
+}
+
+GroupSummary PayrollAggregates::summarize(const PayrollGroup& group) {
+    GroupSummary result;
+    if (group.count == 0) return result;
+
+    result.count = group.count;
+    result.salarySum = group.salarySum;
+    result.bonusSum = group.bonusSum;
+    result.lowKpiCount = group.lowKpiCount;
+    result.minBonus = group.minBonus;
+    result.maxBonus = group.maxBonus;
+    result.worstName = group.worstName;
+    result.bestName = group.bestName;
+    return result;
+}
+
+PayrollSummary PayrollAggregates::summary() const {
+    PayrollSummary result;
+    PayrollGroup company;
+    result.departments.reserve(departments.size());
+    for (const auto& group : departments) {
+        result.departments.push_back(summarize(group));
+        if (group.count == 0) continue;
+
+        company.count += group.count;
+        company.salarySum += group.salarySum;
+        company.bonusSum += group.bonusSum;
+        company.lowKpiCount += group.lowKpiCount;
+        if (group.minBonus < company.minBonus) {
+            company.minBonus = group.minBonus;
+            company.worstName = group.worstName;
+        }
+        if (group.maxBonus >= company.maxBonus) {
+            company.maxBonus = group.maxBonus;
+            company.bestName = group.bestName;
+        }
+    }
+    result.company = summarize(company);
+    return result;
+}
+
+void PayrollModel::update(Group& group, double salary, double kpi, int experience, double sign) {
+    if (group.salaryTree.empty()) {
+        group.salaryTree.assign(MAX_EXPERIENCE + 2, 0);
+        group.salaryExperienceTree.assign(MAX_EXPERIENCE + 2, 0);
+    }
+
+    experience = min(max(experience, 0), (int)MAX_EXPERIENCE);
+    group.count += sign > 0 ? 1 : -1;
+    group.salarySum += sign * salary;
+    group.salaryKpiSum += sign * salary * kpi;
+    for (int i = experience + 1; i <= MAX_EXPERIENCE + 1; i += i & -i) {
+        group.salaryTree[i] += sign * salary;
+        group.salaryExperienceTree[i] += sign * salary * experience;
+    }
+}
+
+double PayrollModel::prefix(const vector<double>& tree, int experience) {
+    double sum = 0;
+    if (tree.empty()) return sum;
+    for (int i = experience + 1; i > 0; i -= i & -i) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+int PayrollModel::experienceCap(const BonusFormula& formula) {
+    int low = 0, high = MAX_EXPERIENCE;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (middle * formula.getExperienceCoefficient() <= formula.getMaxExperienceBonus()) {
+            low = middle;
+        }
+        else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+double PayrollModel::groupTotal(const Group& group, const BonusFormula& formula, int cap) {
+    if (group.count == 0) return 0;
+
+    double cappedSalary = group.salarySum - prefix(group.salaryTree, cap);
+    return group.salaryKpiSum / 100 * formula.getKpiCoefficient() +
+        prefix(group.salaryExperienceTree, cap) * formula.getExperienceCoefficient() +
+        cappedSalary * formula.getMaxExperienceBonus();
+}
+
+void PayrollModel::add(uint32_t department, double salary, double kpi, int experience) {
+    if (department >= departments.size()) departments.resize(department + 1);
+    update(company, salary, kpi, experience, 1);
+    update(departments[department], salary, kpi, experience, 1);
+}
+
+void PayrollModel::remove(uint32_t department, double salary, double kpi, int experience) {
+    update(company, salary, kpi, experience, -1);
+    update(departments[department], salary, kpi, experience, -1);
+}
+
+void PayrollModel::clear() {
+    company = Group();
+    departments.clear();
+}
+
+size_t PayrollModel::memoryBytes() const {
+    size_t trees = 2 * (MAX_EXPERIENCE + 2) * sizeof(double);
+    size_t bytes = sizeof(Group) + trees + departments.capacity() * sizeof(Group);
+    for (const auto& group : departments) {
+        if (!group.salaryTree.empty()) bytes += trees;
+    }
+    return bytes;
+}
+
+PayrollForecast PayrollModel::forecast(const BonusFormula& formula) const {
+    PayrollForecast result;
+    int cap = experienceCap(formula);
+    result.total = groupTotal(company, formula, cap);
+    for (const auto& group : departments) {
+        result.departments.push_back(groupTotal(group, formula, cap));
+    }
+    return result;
+}
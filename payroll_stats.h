@@ -0,0 +1,102 @@
+#ifndef PAYROLL_STATS_H
+#define PAYROLL_STATS_H
+
+#include <vector>
+#include <string_view>
+#include <cstdint>
+#include <limits>
+using namespace std;
+
+class BonusFormula;
+
+//        .   ,  
+//    ,      
+//      .
+struct PayrollGroup {
+    size_t count = 0;
+    double salarySum = 0;
+    double bonusSum = 0;
+    size_t lowKpiCount = 0;
+    double minBonus = numeric_limits<double>::infinity();
+    double maxBonus = -numeric_limits<double>::infinity();
+    string_view worstName;
+    string_view bestName;
+    bool extremesStale = false;
+};
+
+struct GroupSummary {
+    size_t count = 0;
+    double salarySum = 0;
+    double bonusSum = 0;
+    size_t lowKpiCount = 0;
+    double minBonus = 0;
+    double maxBonus = 0;
+    string_view worstName;
+    string_view bestName;
+};
+
+struct PayrollSummary {
+    GroupSummary company;
+    vector<GroupSummary> departments;
+};
+
+class PayrollAggregates {
+private:
+    vector<PayrollGroup> departments;
+
+    static void offer(PayrollGroup& group, double bonus, string_view name);
+    static GroupSummary summarize(const PayrollGroup& group);
+
+public:
+    static const double LOW_KPI_THRESHOLD;
+
+    void add(uint32_t department, double salary, double bonus, double kpi, string_view name);
+    //     ,    .
+    void remove(uint32_t department, double salary, double bonus, double kpi);
+    void clear();
+
+    bool extremesStale(uint32_t department) const { return departments[department].extremesStale; }
+    void resetExtremes(uint32_t department);
+    void offerExtreme(uint32_t department, double bonus, string_view name);
+
+    size_t departmentCount() const { return departments.size(); }
+    size_t memoryBytes() const { return departments.capacity() * sizeof(PayrollGroup); }
+    //      .
+    PayrollSummary summary() const;
+};
+
+struct PayrollForecast {
+    double total = 0;
+    vector<double> departments;
+};
+
+class PayrollModel {
+private:
+    struct Group {
+        size_t count = 0;
+        double salarySum = 0;
+        double salaryKpiSum = 0;
+        vector<double> salaryTree;
+        vector<double> salaryExperienceTree;
+    };
+
+    Group company;
+    vector<Group> departments;
+
+    static void update(Group& group, double salary, double kpi, int experience, double sign);
+    static double prefix(const vector<double>& tree, int experience);
+    static double groupTotal(const Group& group, const BonusFormula& formula, int cap);
+    static int experienceCap(const BonusFormula& formula);
+
+public:
+    static constexpr int MAX_EXPERIENCE = 255;
+
+    void add(uint32_t department, double salary, double kpi, int experience);
+    void remove(uint32_t department, double salary, double kpi, int experience);
+    void clear();
+
+    size_t memoryBytes() const;
+    PayrollForecast forecast(const BonusFormula& formula) const;
+};
+
+#endif
@@ -0,0 +1,142 @@
+#include "record_pool.h"
+#include <new>
+#include <algorithm>
+
+//    operator new   ,   
+//    (-DRECORD_POOL_DIAGNOSTICS).
+#ifdef RECORD_POOL_DIAGNOSTICS
+#include <cstdlib>
+
+namespace {
+    atomic<size_t> heapAllocations(0);
+}
+
+void* operator new(size_t size) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    if (void* block = malloc(size ? size : 1)) return block;
+    throw bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+size_t AllocationCounter::count() {
+    return heapAllocations.load(memory_order_relaxed);
+}
+#endif
+
+RecordPool::RecordPool()
+    : freeList(nullptr), blockSize(0), chunkUsed(0), chunkBlocks(0), bytesReserved(0),
+    allocations(0), releases(0) {}
+
+size_t RecordPool::roundUp(size_t size) {
+    size_t alignment = alignof(max_align_t);
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+thread_local RecordPool::Batch* RecordPool::Batch::current = nullptr;
+
+RecordPool::Batch::Batch(RecordPool* p) : pool(p), blocks(nullptr), blockSize(0), previous(current) {
+    current = this;
+}
+
+RecordPool::Batch::~Batch() {
+    current = previous;
+    if (!blocks) return;
+
+    FreeBlock* last = blocks;
+    size_t count = 1;
+    while (last->next) {
+        last = last->next;
+        count++;
+    }
+    lock_guard<mutex> guard(pool->lock);
+    last->next = pool->freeList;
+    pool->freeList = blocks;
+    pool->allocations -= count;
+}
+
+void* RecordPool::takeBlock() {
+    allocations++;
+    if (freeList) {
+        FreeBlock* block = freeList;
+        freeList = block->next;
+        return block;
+    }
+
+    if (chunkUsed == chunkBlocks) {
+        chunkBlocks = chunkBlocks == 0 ? FIRST_CHUNK_BLOCKS : min(chunkBlocks * 2, MAX_CHUNK_BLOCKS);
+        chunks.emplace_back(new char[blockSize * chunkBlocks]);
+        bytesReserved += blockSize * chunkBlocks;
+        chunkUsed = 0;
+    }
+    return chunks.back().get() + blockSize * chunkUsed++;
+}
+
+void* RecordPool::allocate(size_t size) {
+    Batch* batch = Batch::current;
+    if (batch && batch->pool == this) {
+        if (!batch->blocks) refill(*batch, size);
+        if (batch->blocks && roundUp(size) <= batch->blockSize) {
+            FreeBlock* block = batch->blocks;
+            batch->blocks = block->next;
+            return block;
+        }
+    }
+
+    lock_guard<mutex> guard(lock);
+    if (blockSize == 0) blockSize = roundUp(max(size, sizeof(FreeBlock)));
+    if (roundUp(size) > blockSize) return ::operator new(size);
+    return takeBlock();
+}
+
+void RecordPool::refill(Batch& batch, size_t size) {
+    lock_guard<mutex> guard(lock);
+    if (blockSize == 0) blockSize = roundUp(max(size, sizeof(FreeBlock)));
+    if (roundUp(size) > blockSize) return;
+
+    for (size_t i = 0; i < BATCH_BLOCKS; i++) {
+        FreeBlock* block = static_cast<FreeBlock*>(takeBlock());
+        block->next = batch.blocks;
+        batch.blocks = block;
+    }
+    batch.blockSize = blockSize;
+}
+
+void RecordPool::deallocate(void* block, size_t size) {
+    lock_guard<mutex> guard(lock);
+    if (roundUp(size) > blockSize) {
+        ::operator delete(block);
+        return;
+    }
+
+    releases++;
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeList;
+    freeList = freed;
+}
+
+size_t RecordPool::allocationCount() const {
+    lock_guard<mutex> guard(lock);
+    return allocations;
+}
+
+size_t RecordPool::releaseCount() const {
+    lock_guard<mutex> guard(lock);
+    return releases;
+}
+
+size_t RecordPool::chunkCount() const {
+    lock_guard<mutex> guard(lock);
+    return chunks.size();
+}
+
+size_t RecordPool::reservedBytes() const {
+    lock_guard<mutex> guard(lock);
+    return bytesReserved;
+}
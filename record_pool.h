@@ -0,0 +1,113 @@
+#ifndef RECORD_POOL_H
+#define RECORD_POOL_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+using namespace std;
+
+class RecordPool {
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    vector<unique_ptr<char[]>> chunks;
+    FreeBlock* freeList;
+    size_t blockSize;
+    size_t chunkUsed;
+    size_t chunkBlocks;
+    size_t bytesReserved;
+    size_t allocations;
+    size_t releases;
+    mutable mutex lock;
+
+    static size_t roundUp(size_t size);
+    void* takeBlock();
+
+public:
+    static constexpr size_t FIRST_CHUNK_BLOCKS = 64;
+    static constexpr size_t MAX_CHUNK_BLOCKS = 4096;
+    static constexpr size_t BATCH_BLOCKS = 256;
+
+    // ,     ( ),        .
+    //   , allocate      ;    .
+    class Batch {
+    private:
+        RecordPool* pool;
+        FreeBlock* blocks;
+        size_t blockSize;
+        Batch* previous;
+
+        static thread_local Batch* current;
+        friend class RecordPool;
+
+    public:
+        explicit Batch(RecordPool* p);
+        ~Batch();
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+    };
+
+    RecordPool();
+    RecordPool(const RecordPool&) = delete;
+    RecordPool& operator=(const RecordPool&) = delete;
+
+    void* allocate(size_t size);
+    void deallocate(void* block, size_t size);
+    void refill(Batch& batch, size_t size);
+
+    size_t allocationCount() const;
+    size_t releaseCount() const;
+    size_t chunkCount() const;
+    size_t reservedBytes() const;
+};
+
+template<typename T>
+class PoolAllocator {
+private:
+    RecordPool* pool;
+
+    template<typename U> friend class PoolAllocator;
+
+public:
+    using value_type = T;
+
+    explicit PoolAllocator(RecordPool* p) : pool(p) {}
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : pool(other.pool) {}
+
+    T* allocate(size_t n) {
+        if (n != 1) return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(pool->allocate(sizeof(T)));
+    }
+
+    void deallocate(T* block, size_t n) {
+        if (n != 1) {
+            ::operator delete(block);
+            return;
+        }
+        pool->deallocate(block, sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>& other) const { return pool == other.pool; }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>& other) const { return pool != other.pool; }
+};
+
+template<typename T, typename... Args>
+shared_ptr<T> makePooled(RecordPool* pool, Args&&... args) {
+    if (!pool) return make_shared<T>(forward<Args>(args)...);
+    return allocate_shared<T>(PoolAllocator<T>(pool), forward<Args>(args)...);
+}
+
+#ifdef RECORD_POOL_DIAGNOSTICS
+namespace AllocationCounter {
+    size_t count();
+}
+#endif
+
+#endif
@@ -0,0 +1,142 @@
+#include "search_index.h"
+#include "dictionary.h"
+#include <algorithm>
+#include <iterator>
+
+void TrigramIndex::collectTrigrams(const string& key, vector<uint32_t>& trigrams) {
+    trigrams.clear();
+    for (size_t i = 0; i + 3 <= key.size(); i++) {
+        trigrams.push_back((uint32_t)(unsigned char)key[i] << 16 |
+            (uint32_t)(unsigned char)key[i + 1] << 8 |
+            (uint32_t)(unsigned char)key[i + 2]);
+    }
+    sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+void TrigramIndex::add(size_t row, const string& key) {
+    vector<uint32_t> trigrams;
+    collectTrigrams(key, trigrams);
+    for (uint32_t trigram : trigrams) {
+        vector<uint32_t>& list = postings[trigram];
+        if (list.empty() || list.back() < row) {
+            list.push_back((uint32_t)row);
+        }
+        else {
+            auto it = lower_bound(list.begin(), list.end(), (uint32_t)row);
+            if (it == list.end() || *it != row) list.insert(it, (uint32_t)row);
+        }
+    }
+}
+
+void TrigramIndex::remove(size_t row, const string& key) {
+    vector<uint32_t> trigrams;
+    collectTrigrams(key, trigrams);
+    for (uint32_t trigram : trigrams) {
+        auto found = postings.find(trigram);
+        if (found == postings.end()) continue;
+
+        vector<uint32_t>& list = found->second;
+        auto it = lower_bound(list.begin(), list.end(), (uint32_t)row);
+        if (it != list.end() && *it == row) list.erase(it);
+        if (list.empty()) postings.erase(found);
+    }
+}
+
+void TrigramIndex::shrink() {
+    for (auto& entry : postings) entry.second.shrink_to_fit();
+}
+
+size_t TrigramIndex::memoryBytes() const {
+    size_t bytes = postings.bucket_count() * sizeof(void*);
+    for (const auto& entry : postings) {
+        bytes += sizeof(entry) + sizeof(void*) + entry.second.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+vector<uint32_t>& DepartmentIndex::writable(uint32_t id) {
+    while (rows.size() <= id) {
+        rows.push_back(make_shared<vector<uint32_t>>());
+        shared.push_back(false);
+    }
+    if (shared[id]) {
+        rows[id] = make_shared<vector<uint32_t>>(*rows[id]);
+        shared[id] = false;
+    }
+    return *rows[id];
+}
+
+void DepartmentIndex::add(size_t row, uint32_t id) {
+    vector<uint32_t>& list = writable(id);
+    if (list.empty() || list.back() < row) {
+        list.push_back((uint32_t)row);
+    }
+    else {
+        list.insert(lower_bound(list.begin(), list.end(), (uint32_t)row), (uint32_t)row);
+    }
+}
+
+void DepartmentIndex::remove(size_t row, uint32_t id) {
+    if (id >= rows.size()) return;
+    vector<uint32_t>& list = writable(id);
+    auto it = lower_bound(list.begin(), list.end(), (uint32_t)row);
+    if (it != list.end() && *it == row) list.erase(it);
+}
+
+void DepartmentIndex::clear() {
+    rows.clear();
+    shared.clear();
+}
+
+size_t DepartmentIndex::memoryBytes() const {
+    size_t bytes = rows.capacity() * sizeof(rows[0]) + shared.capacity();
+    for (const auto& list : rows) bytes += sizeof(vector<uint32_t>) + 2 * sizeof(void*) + list->capacity() * sizeof(uint32_t);
+    return bytes;
+}
+
+vector<shared_ptr<const vector<uint32_t>>> DepartmentIndex::freeze() {
+    fill(shared.begin(), shared.end(), true);
+    return vector<shared_ptr<const vector<uint32_t>>>(rows.begin(), rows.end());
+}
+
+int DepartmentIndex::find(const string& department) const {
+    int id = StringDictionary::departments().find(department);
+    return id < 0 || (size_t)id >= rows.size() ? -1 : id;
+}
+
+const vector<uint32_t>& DepartmentIndex::rowsOf(uint32_t id) const {
+    static const vector<uint32_t> noRows;
+    return id < rows.size() ? *rows[id] : noRows;
+}
+
+const string& DepartmentIndex::name(uint32_t id) const {
+    return StringDictionary::departments().name(id);
+}
+
+bool TrigramIndex::candidates(const string& term, vector<uint32_t>& rows) const {
+    rows.clear();
+    if (term.size() < 3) return false;
+
+    vector<uint32_t> trigrams;
+    collectTrigrams(term, trigrams);
+
+    vector<const vector<uint32_t>*> lists;
+    for (uint32_t trigram : trigrams) {
+        auto found = postings.find(trigram);
+        if (found == postings.end()) return true;
+        lists.push_back(&found->second);
+    }
+    sort(lists.begin(), lists.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) {
+        return a->size() < b->size();
+    });
+
+    rows = *lists[0];
+    vector<uint32_t> narrowed;
+    for (size_t i = 1; i < lists.size() && !rows.empty(); i++) {
+        narrowed.clear();
+        set_intersection(rows.begin(), rows.end(), lists[i]->begin(), lists[i]->end(), back_inserter(narrowed));
+        rows.swap(narrowed);
+    }
+    return true;
+}
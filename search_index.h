@@ -0,0 +1,50 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+using namespace std;
+
+class TrigramIndex {
+private:
+    unordered_map<uint32_t, vector<uint32_t>> postings;
+
+    static void collectTrigrams(const string& key, vector<uint32_t>& trigrams);
+
+public:
+    void add(size_t row, const string& key);
+    void remove(size_t row, const string& key);
+    void clear() { postings.clear(); }
+    void shrink();
+    size_t memoryBytes() const;
+
+    bool candidates(const string& term, vector<uint32_t>& rows) const;
+};
+
+//      ,        .
+//            .
+class DepartmentIndex {
+private:
+    vector<shared_ptr<vector<uint32_t>>> rows;
+    vector<char> shared;
+
+    vector<uint32_t>& writable(uint32_t id);
+
+public:
+    void add(size_t row, uint32_t department);
+    void remove(size_t row, uint32_t department);
+    void clear();
+
+    int find(const string& department) const;
+    const vector<uint32_t>& rowsOf(uint32_t id) const;
+    const string& name(uint32_t id) const;
+    size_t departmentCount() const { return rows.size(); }
+    size_t memoryBytes() const;
+
+    vector<shared_ptr<const vector<uint32_t>>> freeze();
+};
+
+#endif
@@ -0,0 +1,230 @@
+#include "snapshot.h"
+#include "classes.h"
+#include "data_loader.h"
+#include "record_pool.h"
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <algorithm>
+
+namespace Snapshot {
+    namespace {
+        const size_t STRING_FIELDS = 5;
+
+        const uint64_t CHECKSUM_SEED = 14695981039346656037ULL;
+        const size_t WRITE_BUFFER = 64 * 1024;
+        const size_t READ_SLICE = 4 << 20;
+        const size_t READ_ROWS = 64 * 1024;
+
+        uint64_t checksum(const char* data, size_t size, uint64_t hash = CHECKSUM_SEED) {
+            for (size_t i = 0; i < size; i++) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        class PayloadWriter {
+        private:
+            ofstream& file;
+            uint64_t hash;
+            vector<char> buffer;
+
+        public:
+            explicit PayloadWriter(ofstream& out) : file(out), hash(CHECKSUM_SEED) {
+                buffer.reserve(WRITE_BUFFER);
+            }
+
+            void put(const char* data, size_t size) {
+                buffer.insert(buffer.end(), data, data + size);
+                if (buffer.size() >= WRITE_BUFFER) flush();
+            }
+
+            template<typename T>
+            void put(const T& value) {
+                put(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            void flush() {
+                hash = checksum(buffer.data(), buffer.size(), hash);
+                file.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+
+            uint64_t result() const { return hash; }
+        };
+
+        bool sourceStamp(const string& sourcePath, uint64_t& size, int64_t& time) {
+            error_code ec;
+            size = filesystem::file_size(sourcePath, ec);
+            if (ec) return false;
+            auto stamp = filesystem::last_write_time(sourcePath, ec);
+            if (ec) return false;
+            time = static_cast<int64_t>(stamp.time_since_epoch().count());
+            return true;
+        }
+
+        size_t payloadSize(uint64_t count, uint64_t heapSize) {
+            return count * (5 * sizeof(double) + sizeof(int32_t) + sizeof(uint8_t)) +
+                (count * STRING_FIELDS + 1) * sizeof(uint64_t) + heapSize;
+        }
+
+        template<typename T>
+        const T* getColumn(const char*& cursor, uint64_t count) {
+            const T* column = reinterpret_cast<const T*>(cursor);
+            cursor += count * sizeof(T);
+            return column;
+        }
+    }
+
+    bool write(const string& path, const string& sourcePath,
+        const function<void(const EmployeeVisitor&)>& forEach, Image image) {
+        Header header = {};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        if (!sourceStamp(sourcePath, header.sourceSize, header.sourceTime)) return false;
+
+        string tempPath = path + ".tmp";
+        ofstream file(tempPath, ios::binary | ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        bool saved = image == Image::Saved;
+        auto number = [saved](double value) { return saved ? (double)(int)value : value; };
+        PayloadWriter payload(file);
+
+        forEach([&](const Employee& emp) {
+            payload.put(number(emp.getSalary()));
+            header.count++;
+        });
+        for (int k = 0; k < 4; k++) {
+            forEach([&](const Employee& emp) { payload.put(number(emp.getKPI()[k])); });
+        }
+        forEach([&](const Employee& emp) { payload.put<int32_t>(emp.getHireDate().serial()); });
+        forEach([&](const Employee& emp) { payload.put<uint8_t>(saved || emp.getIsApproved() ? 1 : 0); });
+
+        uint64_t offset = 0;
+        forEach([&](const Employee& emp) {
+            for (size_t length : { emp.getUsername().size(), emp.getPassword().size(), emp.getFullName().size(),
+                emp.getDepartment().size(), emp.getPosition().size() }) {
+                payload.put(offset);
+                offset += length;
+            }
+        });
+        payload.put(offset);
+        header.heapSize = offset;
+
+        forEach([&](const Employee& emp) {
+            string password = saved ? Encryption::hashPassword(emp.getPassword()) : string(emp.getPassword());
+            for (string_view field : { emp.getUsername(), string_view(password), emp.getFullName(),
+                string_view(emp.getDepartment()), string_view(emp.getPosition()) }) {
+                payload.put(field.data(), field.size());
+            }
+        });
+        payload.flush();
+        header.checksum = payload.result();
+
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+        if (!file) return false;
+
+        error_code ec;
+        filesystem::rename(tempPath, path, ec);
+        return !ec;
+    }
+
+    bool read(const string& path, const string& sourcePath, vector<shared_ptr<Employee>>& employees,
+        StringArena& strings, RecordPool* pool) {
+        MappedFile file;
+        if (!file.open(path)) return false;
+
+        string_view bytes = file.view();
+        if (bytes.size() < sizeof(Header)) return false;
+
+        Header header;
+        memcpy(&header, bytes.data(), sizeof(header));
+        if (header.magic != MAGIC || header.version != VERSION) return false;
+
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        if (!sourceStamp(sourcePath, sourceSize, sourceTime) ||
+            sourceSize != header.sourceSize || sourceTime != header.sourceTime) {
+            return false;
+        }
+
+        const char* payload = bytes.data() + sizeof(Header);
+        size_t size = bytes.size() - sizeof(Header);
+        if (header.count > size || size != payloadSize(header.count, header.heapSize)) {
+            return false;
+        }
+
+        //    ,     :
+        //      .
+        uint64_t hash = CHECKSUM_SEED;
+        for (size_t done = 0; done < size; done += READ_SLICE) {
+            string_view slice(payload + done, min(READ_SLICE, size - done));
+            hash = checksum(slice.data(), slice.size(), hash);
+            file.release(slice);
+        }
+        if (hash != header.checksum) return false;
+
+        uint64_t n = header.count;
+        const char* cursor = payload;
+        const double* salary = getColumn<double>(cursor, n);
+        const double* pc = getColumn<double>(cursor, n);
+        const double* cq = getColumn<double>(cursor, n);
+        const double* tw = getColumn<double>(cursor, n);
+        const double* in = getColumn<double>(cursor, n);
+        const int32_t* hireDay = getColumn<int32_t>(cursor, n);
+        const uint8_t* approved = getColumn<uint8_t>(cursor, n);
+        //     8     ,    .
+        const char* offsets = cursor;
+        const char* heap = offsets + (n * STRING_FIELDS + 1) * sizeof(uint64_t);
+        auto offset = [offsets](size_t k) {
+            uint64_t value;
+            memcpy(&value, offsets + k * sizeof(uint64_t), sizeof(value));
+            return value;
+        };
+
+        vector<shared_ptr<Employee>> loaded;
+        loaded.reserve(n);
+        StringDictionary::Cache departments(StringDictionary::departments());
+        StringDictionary::Cache positions(StringDictionary::positions());
+        RecordPool::Batch batch(pool);
+        string_view fields[STRING_FIELDS];
+        for (size_t first = 0; first < n; first += READ_ROWS) {
+            size_t last = min<size_t>(first + READ_ROWS, n);
+            for (size_t i = first; i < last; i++) {
+                for (size_t f = 0; f < STRING_FIELDS; f++) {
+                    uint64_t begin = offset(i * STRING_FIELDS + f), end = offset(i * STRING_FIELDS + f + 1);
+                    if (begin > end || end > header.heapSize) return false;
+                    fields[f] = string_view(heap + begin, end - begin);
+                }
+                if (fields[0].size() > User::MAX_FIELD || fields[1].size() > User::MAX_FIELD ||
+                    fields[2].size() > User::MAX_FIELD) {
+                    return false;
+                }
+
+                auto emp = makePooled<Employee>(pool, strings, fields[0], PasswordHash{ fields[1] }, fields[2],
+                    departments.intern(fields[3]), positions.intern(fields[4]), salary[i], Date::fromSerial(hireDay[i]));
+                emp->setIsApproved(approved[i] != 0);
+                emp->setKPI(KPI(pc[i], cq[i], tw[i], in[i]));
+                loaded.push_back(emp);
+            }
+
+            //        .
+            for (const char* column : { (const char*)salary, (const char*)pc, (const char*)cq, (const char*)tw, (const char*)in }) {
+                file.release(string_view(column + first * sizeof(double), (last - first) * sizeof(double)));
+            }
+            file.release(string_view((const char*)hireDay + first * sizeof(int32_t), (last - first) * sizeof(int32_t)));
+            uint64_t heapBegin = offset(first * STRING_FIELDS), heapEnd = offset(last * STRING_FIELDS);
+            file.release(string_view(heap + heapBegin, heapEnd - heapBegin));
+            file.release(string_view(offsets + first * STRING_FIELDS * sizeof(uint64_t),
+                (last - first) * STRING_FIELDS * sizeof(uint64_t)));
+        }
+
+        employees.swap(loaded);
+        return true;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <functional>
+using namespace std;
+
+class Employee;
+class RecordPool;
+class StringArena;
+
+namespace Snapshot {
+    const uint32_t MAGIC = 0x504E5342;
+    const uint32_t VERSION = 2;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t count;
+        uint64_t heapSize;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint64_t checksum;
+    };
+
+    // Loaded     ,        sourcePath.
+    // Saved         sourcePath;   ,  
+    //   :    ,   KPI   .
+    enum class Image { Loaded, Saved };
+    using EmployeeVisitor = function<void(const Employee&)>;
+
+    //   : forEach        .
+    bool write(const string& path, const string& sourcePath,
+        const function<void(const EmployeeVisitor&)>& forEach, Image image);
+    bool read(const string& path, const string& sourcePath, vector<shared_ptr<Employee>>& employees,
+        StringArena& strings, RecordPool* pool = nullptr);
+}
+
+#endif
@@ -0,0 +1,78 @@
+#include "store_lock.h"
+#include <utility>
+
+double LockStats::averageWaitMicros() const {
+    return acquisitions ? waitNanos / 1000.0 / acquisitions : 0;
+}
+
+double LockStats::averageHoldMicros() const {
+    return acquisitions ? holdNanos / 1000.0 / acquisitions : 0;
+}
+
+LockCounters::LockCounters() : acquisitions(0), waitNanos(0), holdNanos(0), maxHoldNanos(0) {}
+
+void LockCounters::record(uint64_t wait, uint64_t hold) {
+    acquisitions.fetch_add(1, memory_order_relaxed);
+    waitNanos.fetch_add(wait, memory_order_relaxed);
+    holdNanos.fetch_add(hold, memory_order_relaxed);
+
+    uint64_t longest = maxHoldNanos.load(memory_order_relaxed);
+    while (hold > longest && !maxHoldNanos.compare_exchange_weak(longest, hold, memory_order_relaxed)) {
+    }
+}
+
+LockStats LockCounters::stats() const {
+    LockStats result;
+    result.acquisitions = acquisitions.load(memory_order_relaxed);
+    result.waitNanos = waitNanos.load(memory_order_relaxed);
+    result.holdNanos = holdNanos.load(memory_order_relaxed);
+    result.maxHoldNanos = maxHoldNanos.load(memory_order_relaxed);
+    return result;
+}
+
+CutLock::CutLock(const StoreLock& owner) : global(owner.mutex), table(owner.tableMutex) {
+    departments.reserve(owner.departments.size());
+    for (auto& department : owner.departments) {
+        departments.emplace_back(department);
+    }
+}
+
+void CutLock::unlock() {
+    for (auto it = departments.rbegin(); it != departments.rend(); ++it) {
+        it->unlock();
+    }
+    departments.clear();
+    table.unlock();
+    global.unlock();
+}
+
+DepartmentLock::DepartmentLock(const StoreLock& owner, uint32_t first, uint32_t second) : global(owner.mutex) {
+    if (first > second) swap(first, second);
+    shared_mutex& a = owner.department(first);
+    shared_mutex& b = owner.department(second);
+    lower = unique_lock<shared_mutex>(a);
+    if (second != first) higher = unique_lock<shared_mutex>(b);
+}
+
+void DepartmentLock::unlock() {
+    if (higher.owns_lock()) higher.unlock();
+    lower.unlock();
+    global.unlock();
+}
+
+shared_mutex& StoreLock::department(uint32_t departmentId) const {
+    {
+        shared_lock<shared_mutex> lock(tableMutex);
+        if (departmentId < departments.size()) return departments[departmentId];
+    }
+    //    deque      .
+    unique_lock<shared_mutex> lock(tableMutex);
+    while (departments.size() <= departmentId) {
+        departments.emplace_back();
+    }
+    return departments[departmentId];
+}
+
+LockStats StoreLock::readStats() const { return readCounters.stats(); }
+LockStats StoreLock::writeStats() const { return writeCounters.stats(); }
+LockStats StoreLock::editStats() const { return editCounters.stats(); }
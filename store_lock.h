@@ -0,0 +1,139 @@
+#ifndef STORE_LOCK_H
+#define STORE_LOCK_H
+
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+struct LockStats {
+    uint64_t acquisitions = 0;
+    uint64_t waitNanos = 0;
+    uint64_t holdNanos = 0;
+    uint64_t maxHoldNanos = 0;
+
+    double averageWaitMicros() const;
+    double averageHoldMicros() const;
+};
+
+class LockCounters {
+private:
+    atomic<uint64_t> acquisitions;
+    atomic<uint64_t> waitNanos;
+    atomic<uint64_t> holdNanos;
+    atomic<uint64_t> maxHoldNanos;
+
+public:
+    LockCounters();
+
+    void record(uint64_t wait, uint64_t hold);
+    LockStats stats() const;
+};
+
+class StoreLock;
+
+//       :     .
+class CutLock {
+private:
+    shared_lock<shared_mutex> global;
+    shared_lock<shared_mutex> table;
+    vector<shared_lock<shared_mutex>> departments;
+
+public:
+    explicit CutLock(const StoreLock& owner);
+
+    bool owns_lock() const { return global.owns_lock(); }
+    void unlock();
+};
+
+//      -    ,    .
+class DepartmentLock {
+private:
+    shared_lock<shared_mutex> global;
+    unique_lock<shared_mutex> lower;
+    unique_lock<shared_mutex> higher;
+
+public:
+    DepartmentLock(const StoreLock& owner, uint32_t first, uint32_t second);
+
+    bool owns_lock() const { return global.owns_lock(); }
+    void unlock();
+};
+
+template<typename Lock>
+class TimedGuard {
+private:
+    LockCounters* counters;
+    chrono::steady_clock::time_point requested;
+    Lock lock;
+    chrono::steady_clock::time_point acquired;
+
+public:
+    template<typename... Args>
+    TimedGuard(LockCounters& c, Args&&... args)
+        : counters(&c), requested(chrono::steady_clock::now()), lock(forward<Args>(args)...),
+        acquired(chrono::steady_clock::now()) {}
+
+    TimedGuard(TimedGuard&& other) noexcept
+        : counters(other.counters), requested(other.requested), lock(move(other.lock)),
+        acquired(other.acquired) {
+        other.counters = nullptr;
+    }
+
+    TimedGuard(const TimedGuard&) = delete;
+    TimedGuard& operator=(const TimedGuard&) = delete;
+    TimedGuard& operator=(TimedGuard&&) = delete;
+
+    ~TimedGuard() { release(); }
+
+    void release() {
+        if (!counters || !lock.owns_lock()) return;
+        auto released = chrono::steady_clock::now();
+        lock.unlock();
+        counters->record(chrono::duration_cast<chrono::nanoseconds>(acquired - requested).count(),
+            chrono::duration_cast<chrono::nanoseconds>(released - acquired).count());
+        counters = nullptr;
+    }
+};
+
+class StoreLock {
+private:
+    friend class CutLock;
+    friend class DepartmentLock;
+
+    mutable shared_mutex mutex;
+    //        tableMutex;   
+    // ,         .
+    mutable shared_mutex tableMutex;
+    mutable deque<shared_mutex> departments;
+    mutable LockCounters readCounters;
+    LockCounters writeCounters;
+    LockCounters editCounters;
+
+    shared_mutex& department(uint32_t departmentId) const;
+
+public:
+    using ReadGuard = TimedGuard<CutLock>;
+    using WriteGuard = TimedGuard<unique_lock<shared_mutex>>;
+    using EditGuard = TimedGuard<DepartmentLock>;
+
+    StoreLock() = default;
+    StoreLock(const StoreLock&) = delete;
+    StoreLock& operator=(const StoreLock&) = delete;
+
+    ReadGuard read() const { return ReadGuard(readCounters, *this); }
+    WriteGuard write() { return WriteGuard(writeCounters, mutex); }
+    //  :       .
+    EditGuard edit(uint32_t departmentId) { return EditGuard(editCounters, *this, departmentId, departmentId); }
+    EditGuard edit(uint32_t from, uint32_t to) { return EditGuard(editCounters, *this, from, to); }
+
+    LockStats readStats() const;
+    LockStats writeStats() const;
+    LockStats editStats() const;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "string_arena.h"
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+
+StringArena::StringArena(StringArena* owner)
+    : chunkUsed(0), chunkCapacity(0), bytesStored(0), bytesReserved(0), parent(owner) {}
+
+string_view StringArena::store(string_view value) {
+    return store({ value });
+}
+
+string_view StringArena::store(initializer_list<string_view> parts) {
+    size_t size = 0;
+    for (string_view part : parts) size += part.size();
+    if (size == 0) return string_view();
+
+    lock_guard<mutex> guard(lock);
+    if (chunkUsed + size > chunkCapacity) {
+        size_t capacity = max(CHUNK_SIZE, size);
+        chunks.emplace_back(new char[capacity]);
+        chunkUsed = 0;
+        chunkCapacity = capacity;
+        bytesReserved += capacity;
+    }
+
+    char* target = chunks.back().get() + chunkUsed;
+    char* cursor = target;
+    for (string_view part : parts) {
+        if (part.empty()) continue;
+        memcpy(cursor, part.data(), part.size());
+        cursor += part.size();
+    }
+    chunkUsed += size;
+    bytesStored += size;
+    return string_view(target, size);
+}
+
+void StringArena::adopt(StringArena& local) {
+    scoped_lock guard(lock, local.lock);
+    if (local.chunks.empty()) return;
+
+    //    ,      .
+    auto position = chunks.empty() ? chunks.end() : chunks.end() - 1;
+    if (chunks.empty()) {
+        chunkUsed = local.chunkUsed;
+        chunkCapacity = local.chunkCapacity;
+    }
+    chunks.insert(position, make_move_iterator(local.chunks.begin()), make_move_iterator(local.chunks.end()));
+    bytesStored += local.bytesStored;
+    bytesReserved += local.bytesReserved;
+
+    local.chunks.clear();
+    local.chunkUsed = local.chunkCapacity = local.bytesStored = local.bytesReserved = 0;
+}
+
+size_t StringArena::storedBytes() const {
+    lock_guard<mutex> guard(lock);
+    return bytesStored;
+}
+
+size_t StringArena::reservedBytes() const {
+    lock_guard<mutex> guard(lock);
+    return bytesReserved;
+}
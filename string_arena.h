@@ -0,0 +1,40 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <initializer_list>
+using namespace std;
+
+class StringArena {
+private:
+    vector<unique_ptr<char[]>> chunks;
+    size_t chunkUsed;
+    size_t chunkCapacity;
+    size_t bytesStored;
+    size_t bytesReserved;
+    StringArena* parent;
+    mutable mutex lock;
+
+public:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    //        ,      .
+    explicit StringArena(StringArena* owner = nullptr);
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    string_view store(string_view value);
+    //     ;   .
+    string_view store(initializer_list<string_view> parts);
+    // ,      ;   ,   .
+    StringArena& owner() { return parent ? *parent : *this; }
+    void adopt(StringArena& local);
+    size_t storedBytes() const;
+    size_t reservedBytes() const;
+};
+
+#endif
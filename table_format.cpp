@@ -1,25 +1,48 @@
 #include "table_format.h"
+#include <cstdio>
+#include <algorithm>
 
-string centerText(const string& text, int width) {
-    if (text.length() >= width) return text.substr(0, width);
+string centerText(string_view text, int width) {
+    if (text.length() >= width) return string(text.substr(0, width));
     int padding = width - text.length();
     int leftPadding = padding / 2;
     int rightPadding = padding - leftPadding;
-    return string(leftPadding, ' ') + text + string(rightPadding, ' ');
+    string result;
+    result.reserve(width);
+    result.append(leftPadding, ' ').append(text).append(rightPadding, ' ');
+    return result;
 }
 
-vector<string> splitText(const string& text, int width) {
+CenteredText centered(string_view text, int width) {
+    return { text.substr(0, max(width, 0)), width };
+}
+
+ostream& operator<<(ostream& os, const CenteredText& cell) {
+    int padding = cell.width - (int)cell.text.length();
+    int leftPadding = padding / 2;
+    for (int i = 0; i < leftPadding; i++) os.put(' ');
+    os.write(cell.text.data(), cell.text.length());
+    for (int i = leftPadding; i < padding; i++) os.put(' ');
+    return os;
+}
+
+vector<string> splitText(string_view text, int width) {
     vector<string> lines;
-    stringstream ss(text);
-    string word;
     string currentLine;
 
-    while (ss >> word) {
+    size_t position = 0;
+    while (position < text.size()) {
+        while (position < text.size() && isspace((unsigned char)text[position])) position++;
+        size_t start = position;
+        while (position < text.size() && !isspace((unsigned char)text[position])) position++;
+        if (start == position) break;
+
+        string_view word = text.substr(start, position - start);
         if (currentLine.empty()) {
             currentLine = word;
         }
         else if (currentLine.length() + word.length() + 1 <= width) {
-            currentLine += " " + word;
+            currentLine.append(" ").append(word);
         }
         else {
             lines.push_back(currentLine);
@@ -35,18 +58,11 @@ vector<string> splitText(const string& text, int width) {
 }
 
 string formatDouble(double value, int width) {
-    stringstream stream;
-    stream << fixed << setprecision(2) << value << " BYN";
-    string formattedValue = stream.str();
-
-    if (formattedValue.length() > width) {
-        return formattedValue.substr(0, width);
-    }
+    char buffer[64];
+    int length = snprintf(buffer, sizeof(buffer), "%.2f BYN", value);
+    string_view formattedValue(buffer, length < 0 ? 0 : min<size_t>(length, sizeof(buffer) - 1));
 
-    int padding = width - formattedValue.length();
-    int leftPadding = padding / 2;
-    int rightPadding = padding - leftPadding;
-    return string(leftPadding, ' ') + formattedValue + string(rightPadding, ' ');
+    return centerText(formattedValue, width);
 }
 
 void drawTableLine() {
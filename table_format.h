@@ -2,14 +2,23 @@
 #define TABLE_FORMAT_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 #include <iomanip>
+#include <cctype>
 #include <iostream>
 using namespace std;
 
-string centerText(const string& text, int width);
-vector<string> splitText(const string& text, int width);
+struct CenteredText {
+    string_view text;
+    int width;
+};
+
+string centerText(string_view text, int width);
+CenteredText centered(string_view text, int width);
+ostream& operator<<(ostream& os, const CenteredText& cell);
+vector<string> splitText(string_view text, int width);
 string formatDouble(double value, int width);
 void drawTableLine();
 void drawTableHeader();
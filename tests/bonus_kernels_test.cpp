@@ -0,0 +1,90 @@
+//      .
+// : g++ -std=c++17 -O2 tests/bonus_kernels_test.cpp bonus_kernels.cpp -o bonus_kernels_test
+#include "../bonus_kernels.h"
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace std;
+using namespace BonusKernels;
+
+namespace {
+    struct Inputs {
+        vector<double> pc, cq, tw, in, salary;
+        vector<int> experience;
+    };
+
+    Inputs makeInputs(size_t count, mt19937& random) {
+        uniform_real_distribution<double> kpi(0, 100), salary(0, 500000);
+        uniform_int_distribution<int> experience(0, 40);
+        Inputs inputs;
+        for (size_t i = 0; i < count; i++) {
+            inputs.pc.push_back(kpi(random));
+            inputs.cq.push_back(kpi(random));
+            inputs.tw.push_back(kpi(random));
+            inputs.in.push_back(kpi(random));
+            inputs.salary.push_back(salary(random));
+            inputs.experience.push_back(experience(random));
+        }
+        //  : ,       .
+        if (count > 2) {
+            inputs.pc[0] = inputs.cq[0] = inputs.tw[0] = inputs.in[0] = 0;
+            inputs.pc[1] = inputs.cq[1] = inputs.tw[1] = inputs.in[1] = 100;
+            inputs.experience[2] = 1000;
+        }
+        return inputs;
+    }
+
+    void run(const Inputs& inputs, vector<double>& total, vector<double>& bonus) {
+        size_t count = inputs.salary.size();
+        total.assign(count, -1);
+        bonus.assign(count, -1);
+        totalKPI(inputs.pc.data(), inputs.cq.data(), inputs.tw.data(), inputs.in.data(), total.data(), count);
+        BonusKernels::bonus(inputs.salary.data(), total.data(), inputs.experience.data(), bonus.data(), count,
+            0.15, 0.02, 0.3);
+    }
+
+    bool sameBits(const vector<double>& a, const vector<double>& b) {
+        return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+    }
+}
+
+int main() {
+    mt19937 random(2024);
+    int failures = 0;
+    Level best = detectLevel();
+    cout << " : " << levelName(best) << endl;
+
+    //   ,       2   4 .
+    for (size_t count : { 0, 1, 2, 3, 4, 5, 7, 8, 9, 31, 1000, 1003 }) {
+        Inputs inputs = makeInputs(count, random);
+        vector<double> scalarTotal, scalarBonus;
+        setLevel(Level::Scalar);
+        run(inputs, scalarTotal, scalarBonus);
+
+        for (size_t i = 0; i < count; i++) {
+            double total = BonusKernels::totalKPI(inputs.pc[i], inputs.cq[i], inputs.tw[i], inputs.in[i]);
+            double single = BonusKernels::bonus(inputs.salary[i], total, inputs.experience[i], 0.15, 0.02, 0.3);
+            if (memcmp(&total, &scalarTotal[i], sizeof(double)) != 0 || memcmp(&single, &scalarBonus[i], sizeof(double)) != 0) {
+                cout << "  , n = " << count << ",  " << i << endl;
+                failures++;
+                break;
+            }
+        }
+
+        for (Level level : { Level::SSE42, Level::AVX2 }) {
+            if (level > best) continue;
+            setLevel(level);
+            vector<double> total, bonus;
+            run(inputs, total, bonus);
+            if (!sameBits(total, scalarTotal) || !sameBits(bonus, scalarBonus)) {
+                cout << " " << levelName(level) << "   , n = " << count << endl;
+                failures++;
+            }
+        }
+    }
+
+    setLevel(best);
+    cout << (failures == 0 ? "OK" : "FAILED") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+//      ,     ,    .
+// : g++ -std=c++17 -O2 -pthread tests/snapshot_test.cpp < .cpp ,  main.cpp> -o snapshot_test
+#include "../classes.h"
+#include "../data_loader.h"
+#include "../snapshot.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const string& what) {
+        if (!condition) {
+            cout << ": " << what << endl;
+            failures++;
+        }
+    }
+
+    bool sameRecord(const Employee& a, const Employee& b) {
+        KPI ka = a.getKPI(), kb = b.getKPI();
+        for (int k = 0; k < 4; k++) {
+            if (ka[k] != kb[k]) return false;
+        }
+        return a.toFileString() == b.toFileString() && a.getPassword() == b.getPassword() &&
+            a.getSalary() == b.getSalary() && a.getIsApproved() == b.getIsApproved() &&
+            a.getHireDate().serial() == b.getHireDate().serial();
+    }
+
+    void compare(const vector<shared_ptr<Employee>>& expected, const vector<shared_ptr<Employee>>& actual,
+        const string& what) {
+        check(expected.size() == actual.size(), what + ":  ");
+        for (size_t i = 0; i < expected.size() && i < actual.size(); i++) {
+            check(sameRecord(*expected[i], *actual[i]), what + ":  " + to_string(i));
+        }
+    }
+
+    void writeText(const string& path, const vector<shared_ptr<Employee>>& employees) {
+        ofstream file(path, ios::binary | ios::trunc);
+        file << "admin,418<;dgf, ,admin,1,2024-01-01\n";
+        for (const auto& emp : employees) file << emp->toFileString() << '\n';
+    }
+
+    function<void(const Snapshot::EmployeeVisitor&)> all(const vector<shared_ptr<Employee>>& employees) {
+        return [&employees](const Snapshot::EmployeeVisitor& visit) {
+            for (const auto& emp : employees) visit(*emp);
+        };
+    }
+}
+
+int main() {
+    filesystem::path dir = filesystem::temp_directory_path() / "snapshot_test";
+    filesystem::create_directories(dir);
+    string text = (dir / "users.txt").string();
+    string snapshot = (dir / "users.txt.bin").string();
+
+    //    KPI,   'y', '_', 'X'        .
+    StringArena memoryStrings;
+    vector<shared_ptr<Employee>> memory;
+    memory.push_back(make_shared<Employee>(memoryStrings, "user01", "qwerty", "  ",
+        "", "Junior Developer", 6500.75, Date(12, 12, 2020)));
+    memory.push_back(make_shared<Employee>(memoryStrings, "user02", "my_pass\\X", " ",
+        "", "UI/UX Designer", 9500, Date(15, 3, 2019)));
+    memory.push_back(make_shared<Employee>(memoryStrings, "user03", "yyyy", " ",
+        "", "QA Engineer", 8500.2, Date(29, 2, 2020)));
+    memory[0]->setKPI(KPI(20.5, 70, 65.99, 50));
+    memory[1]->setKPI(KPI(85, 90, 80, 75));
+    memory[2]->setKPI(KPI(0, 100, 0.01, 99.5));
+
+    //   .
+    writeText(text, memory);
+    check(Snapshot::write(snapshot, text, all(memory), Snapshot::Image::Saved), "   ");
+
+    StringArena textStrings, snapshotStrings;
+    LoadResult reloaded = DataLoader::loadFile(text, textStrings);
+    check(reloaded.errors.empty(), "    ");
+    vector<shared_ptr<Employee>> fromSnapshot;
+    check(Snapshot::read(snapshot, text, fromSnapshot, snapshotStrings), "   ");
+    compare(reloaded.employees, fromSnapshot, "  ");
+
+    //    .
+    check(Snapshot::write(snapshot, text, all(reloaded.employees), Snapshot::Image::Loaded),
+        "   ");
+    StringArena loadedStrings;
+    vector<shared_ptr<Employee>> loaded;
+    check(Snapshot::read(snapshot, text, loaded, loadedStrings), "   ");
+    compare(reloaded.employees, loaded, "  ");
+
+    //      .
+    {
+        ofstream file(text, ios::binary | ios::app);
+        file << memory[0]->toFileString() << '\n';
+    }
+    StringArena staleStrings;
+    vector<shared_ptr<Employee>> stale;
+    check(!Snapshot::read(snapshot, text, stale, staleStrings), "  ");
+
+    filesystem::remove_all(dir);
+    cout << (failures == 0 ? "OK" : "FAILED") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+//       ,         .
+// : g++ -std=c++17 -O2 -pthread tests/store_lock_test.cpp store_lock.cpp -o store_lock_test
+#include "../store_lock.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const string& what) {
+        if (!condition) {
+            cout << ": " << what << endl;
+            failures++;
+        }
+    }
+
+    bool waitFor(const atomic<bool>& flag, chrono::milliseconds timeout) {
+        auto deadline = chrono::steady_clock::now() + timeout;
+        while (!flag.load() && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        return flag.load();
+    }
+
+    //   held,   acquire    ,    .
+    template<typename Held, typename Acquire>
+    void expect(StoreLock& lock, Held held, Acquire acquire, bool parallel, const string& what) {
+        auto guard = held(lock);
+        atomic<bool> acquired(false);
+        thread other([&]() {
+            auto second = acquire(lock);
+            acquired = true;
+        });
+        if (parallel) {
+            check(waitFor(acquired, chrono::seconds(5)), what + ":   ");
+        }
+        else {
+            check(!waitFor(acquired, chrono::milliseconds(100)), what + ":    ");
+            guard.release();
+            check(waitFor(acquired, chrono::seconds(5)), what + ":     ");
+        }
+        other.join();
+    }
+}
+
+int main() {
+    auto edit = [](uint32_t department) {
+        return [department](StoreLock& lock) { return lock.edit(department); };
+    };
+    auto move = [](uint32_t from, uint32_t to) {
+        return [from, to](StoreLock& lock) { return lock.edit(from, to); };
+    };
+    auto read = [](StoreLock& lock) { return lock.read(); };
+    auto write = [](StoreLock& lock) { return lock.write(); };
+
+    {
+        StoreLock lock;
+        expect(lock, edit(1), edit(2), true, "  ");
+        expect(lock, edit(1), edit(1), false, "  ");
+        expect(lock, move(1, 3), edit(3), false, "   ");
+        expect(lock, move(3, 1), edit(1), false, "      ");
+        expect(lock, move(1, 3), edit(2), true, "    ");
+        expect(lock, edit(2), read, false, "  ");
+        expect(lock, read, edit(2), false, "  ");
+        expect(lock, read, read, true, "    ");
+        expect(lock, edit(2), write, false, "  ");
+        expect(lock, write, edit(2), false, "  ");
+        //            .
+        expect(lock, read, edit(40), false, "    ");
+    }
+
+    {
+        //      ,        .
+        StoreLock lock;
+        const uint32_t departments = 4;
+        const int rounds = 20000;
+        vector<long long> counters(departments, 0);
+        vector<thread> threads;
+        for (uint32_t t = 0; t < 8; t++) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < rounds; i++) {
+                    uint32_t from = (t + i) % departments, to = (t * 3 + i * 7 + 1) % departments;
+                    StoreLock::EditGuard guard = t % 2 ? lock.edit(from, to) : lock.edit(to, from);
+                    counters[from]--;
+                    counters[to]++;
+                }
+            });
+        }
+        atomic<bool> consistent(true);
+        thread reader([&]() {
+            for (int i = 0; i < 2000; i++) {
+                StoreLock::ReadGuard guard = lock.read();
+                long long sum = 0;
+                for (long long value : counters) sum += value;
+                if (sum != 0) consistent = false;
+            }
+        });
+        for (auto& t : threads) t.join();
+        reader.join();
+
+        long long sum = 0;
+        for (long long value : counters) sum += value;
+        check(sum == 0, " :  ");
+        check(consistent, " :    ");
+        check(lock.editStats().acquisitions == 8ull * rounds, " :  ");
+    }
+
+    cout << (failures == 0 ? "OK" : "FAILED") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -1,7 +1,8 @@
 #include "validation.h"
+#include "classes.h"
 
-string toLowerRussian(const string& str) {
-    string result = str;
+string toLowerRussian(string_view str) {
+    string result(str);
     for (char& c : result) {
         if (c >= '' && c <= '') c = c + 32;
         else if (c >= 'A' && c <= 'Z') c = c + 32;
@@ -22,6 +23,11 @@ bool isValidName(const string& name) {
         return false;
     }
 
+    if (name.length() > User::MAX_FIELD) {
+        cout << ":      " << User::MAX_FIELD << " .\n";
+        return false;
+    }
+
     for (char c : name) {
         if ((c >= '0' && c <= '9') ||
             !((c >= '' && c <= '') ||
@@ -49,8 +55,8 @@ bool isValidName(const string& name) {
 }
 
 bool isValidYear(int year) {
-    if (year < 1900 || year > 2100) {
-        cout << ":     1900  2100.\n";
+    if (year < Date::MIN_YEAR || year > Date::MAX_YEAR) {
+        cout << ":     " << Date::MIN_YEAR << "  " << Date::MAX_YEAR << ".\n";
         return false;
     }
     return true;
@@ -70,10 +76,8 @@ bool isValidDay(int day, int month, int year) {
         return false;
     }
 
-    int daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
-
     if (month == 2) {
-        bool isLeap = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+        bool isLeap = Date::isLeapYear(year);
         if (isLeap && day > 29) {
             cout << ":      29 .\n";
             return false;
@@ -83,8 +87,8 @@ bool isValidDay(int day, int month, int year) {
             return false;
         }
     }
-    else if (day > daysInMonth[month - 1]) {
-        cout << ":     " << daysInMonth[month - 1] << " .\n";
+    else if (day > Date::daysInMonth(year, month)) {
+        cout << ":     " << Date::daysInMonth(year, month) << " .\n";
         return false;
     }
 
@@ -168,6 +172,10 @@ bool isValidDepartment(const string& department) {
         cout << ":     .\n";
         return false;
     }
+    if (department.find(',') != string::npos) {
+        cout << ":      .\n";
+        return false;
+    }
     return true;
 }
 
@@ -176,5 +184,9 @@ bool isValidPosition(const string& position) {
         cout << ":     .\n";
         return false;
     }
+    if (position.find(',') != string::npos) {
+        cout << ":      .\n";
+        return false;
+    }
     return true;
 }
\ No newline at end of file
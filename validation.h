@@ -2,10 +2,11 @@
 #define VALIDATION_H
 
 #include <string>
+#include <string_view>
 #include <iostream>
 using namespace std;
 
-string toLowerRussian(const string& str);
+string toLowerRussian(string_view str);
 bool equalsIgnoreCase(const string& str1, const string& str2);
 bool isValidName(const string& name);
 bool isValidYear(int year);
@@ -0,0 +1,94 @@
+#include "what_if.h"
+#include "bonus_kernels.h"
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+size_t SweepRange::count() const {
+    if (step <= 0 || to <= from) return 1;
+    return (size_t)((to - from) / step + 1e-9) + 1;
+}
+
+double SweepRange::at(size_t index) const {
+    return from + index * step;
+}
+
+FormulaSweep::FormulaSweep(const vector<double>& salary, const vector<double>& kpiScore,
+    const vector<int>& experience, const vector<uint32_t>& department, size_t departmentCount)
+    : salary(salary), kpiScore(kpiScore), experience(experience), department(department),
+    departmentCount(departmentCount) {}
+
+void FormulaSweep::evaluate(SweepPoint& point, vector<double>& bonus) const {
+    size_t count = salary.size();
+    BonusKernels::bonus(salary.data(), kpiScore.data(), experience.data(), bonus.data(), count,
+        point.kpiCoefficient, point.experienceCoefficient, point.maxExperienceBonus);
+
+    point.total = 0;
+    point.departments.assign(departmentCount, 0);
+    for (size_t row = 0; row < count; row++) {
+        point.total += bonus[row];
+        point.departments[department[row]] += bonus[row];
+    }
+
+    point.median = 0;
+    if (count == 0) return;
+
+    size_t middle = count / 2;
+    nth_element(bonus.begin(), bonus.begin() + middle, bonus.end());
+    point.median = bonus[middle];
+    if (count % 2 == 0) {
+        double lower = *max_element(bonus.begin(), bonus.begin() + middle);
+        point.median = (lower + point.median) / 2;
+    }
+}
+
+vector<SweepPoint> FormulaSweep::run(const SweepRange& kpi, const SweepRange& exp, const SweepRange& maxExp) const {
+    size_t kpiCount = kpi.count(), expCount = exp.count(), maxCount = maxExp.count();
+    size_t total = kpiCount * expCount * maxCount;
+    if (total > MAX_POINTS) return {};
+
+    vector<SweepPoint> points(total);
+    size_t index = 0;
+    for (size_t i = 0; i < kpiCount; i++) {
+        for (size_t j = 0; j < expCount; j++) {
+            for (size_t k = 0; k < maxCount; k++) {
+                points[index].kpiCoefficient = kpi.at(i);
+                points[index].experienceCoefficient = exp.at(j);
+                points[index].maxExperienceBonus = maxExp.at(k);
+                index++;
+            }
+        }
+    }
+
+    size_t workers = min<size_t>(max(1u, thread::hardware_concurrency()), total);
+    vector<thread> threads;
+    for (size_t w = 0; w < workers; w++) {
+        threads.emplace_back([this, &points, w, workers]() {
+            vector<double> bonus(salary.size());
+            for (size_t p = w; p < points.size(); p += workers) {
+                evaluate(points[p], bonus);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    return points;
+}
+
+bool FormulaSweep::writeCsv(const string& filename, const vector<SweepPoint>& points,
+    const vector<string>& departmentNames) {
+    ofstream file(filename);
+    if (!file) return false;
+
+    file << "kpi_coefficient;experience_coefficient;max_experience_bonus;total;median";
+    for (const auto& name : departmentNames) file << ";" << name;
+    file << "\n";
+
+    for (const auto& point : points) {
+        file << point.kpiCoefficient << ";" << point.experienceCoefficient << ";"
+            << point.maxExperienceBonus << ";" << point.total << ";" << point.median;
+        for (double value : point.departments) file << ";" << value;
+        file << "\n";
+    }
+    return file.good();
+}
@@ -0,0 +1,48 @@
+#ifndef WHAT_IF_H
+#define WHAT_IF_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+struct SweepRange {
+    double from;
+    double to;
+    double step;
+
+    size_t count() const;
+    double at(size_t index) const;
+};
+
+struct SweepPoint {
+    double kpiCoefficient;
+    double experienceCoefficient;
+    double maxExperienceBonus;
+    double total;
+    double median;
+    vector<double> departments;
+};
+
+class FormulaSweep {
+private:
+    const vector<double>& salary;
+    const vector<double>& kpiScore;
+    const vector<int>& experience;
+    const vector<uint32_t>& department;
+    size_t departmentCount;
+
+    void evaluate(SweepPoint& point, vector<double>& bonus) const;
+
+public:
+    static constexpr size_t MAX_POINTS = 100000;
+
+    FormulaSweep(const vector<double>& salary, const vector<double>& kpiScore,
+        const vector<int>& experience, const vector<uint32_t>& department, size_t departmentCount);
+
+    vector<SweepPoint> run(const SweepRange& kpi, const SweepRange& exp, const SweepRange& maxExp) const;
+    static bool writeCsv(const string& filename, const vector<SweepPoint>& points,
+        const vector<string>& departmentNames);
+};
+
+#endif